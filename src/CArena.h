@@ -0,0 +1,163 @@
+#ifndef CArena_H
+#define CArena_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Bump allocator owning all objects created in it.
+//
+// Objects are placement constructed in a chain of blocks (normally just one)
+// and destroyed in reverse order of creation when the arena is destroyed.
+class CArena {
+ public:
+  explicit CArena(size_t blockSize=16384) :
+   blockSize_(blockSize) {
+  }
+
+ ~CArena() {
+    clear();
+  }
+
+  CArena(const CArena &) = delete;
+  CArena &operator=(const CArena &) = delete;
+
+  template<typename T, typename... Args>
+  T *create(Args&&... args) {
+    void *mem = alloc(sizeof(T), alignof(T));
+
+    T *t = new (mem) T(std::forward<Args>(args)...);
+
+    if (! std::is_trivially_destructible<T>::value) {
+      Dtor *dtor = new (alloc(sizeof(Dtor), alignof(Dtor))) Dtor;
+
+      dtor->destroy = [](void *p) { static_cast<T *>(p)->~T(); };
+      dtor->ptr     = t;
+      dtor->next    = dtors_;
+
+      dtors_ = dtor;
+    }
+
+    return t;
+  }
+
+  // uninitialized (zeroed) array of trivial type
+  template<typename T>
+  T *createArray(size_t n) {
+    static_assert(std::is_trivial<T>::value, "array type must be trivial");
+
+    if (n == 0) return nullptr;
+
+    T *t = static_cast<T *>(alloc(n*sizeof(T), alignof(T)));
+
+    memset(t, 0, n*sizeof(T));
+
+    return t;
+  }
+
+  // destroy all objects and free all blocks
+  void clear() {
+    for (Dtor *dtor = dtors_; dtor; dtor = dtor->next)
+      dtor->destroy(dtor->ptr);
+
+    dtors_ = nullptr;
+
+    while (blocks_) {
+      Block *next = blocks_->next;
+
+      free(blocks_);
+
+      blocks_ = next;
+    }
+
+    size_ = 0;
+    used_ = 0;
+  }
+
+  // bytes allocated from system
+  size_t size() const { return size_; }
+
+  // bytes used by objects (including alignment and destructor records)
+  size_t used() const { return used_; }
+
+  int numBlocks() const {
+    int n = 0;
+
+    for (Block *block = blocks_; block; block = block->next)
+      ++n;
+
+    return n;
+  }
+
+ private:
+  struct Block {
+    Block *next;
+    size_t size;
+    size_t pos;
+  };
+
+  struct Dtor {
+    void (*destroy)(void *);
+    void  *ptr;
+    Dtor  *next;
+  };
+
+  void *alloc(size_t size, size_t align) {
+    if (blocks_) {
+      void *p = allocInBlock(blocks_, size, align);
+
+      if (p) return p;
+    }
+
+    size_t blockSize = blockSize_;
+
+    if (blockSize < size + align + sizeof(Block))
+      blockSize = size + align + sizeof(Block);
+
+    Block *block = static_cast<Block *>(malloc(blockSize));
+
+    if (! block)
+      throw std::bad_alloc();
+
+    block->next = blocks_;
+    block->size = blockSize;
+    block->pos  = sizeof(Block);
+
+    blocks_ = block;
+
+    size_ += blockSize;
+    used_ += sizeof(Block);
+
+    return allocInBlock(block, size, align);
+  }
+
+  void *allocInBlock(Block *block, size_t size, size_t align) {
+    char *base = reinterpret_cast<char *>(block);
+
+    size_t addr = reinterpret_cast<size_t>(base + block->pos);
+    size_t pad  = (align - addr % align) % align;
+
+    if (block->pos + pad + size > block->size)
+      return nullptr;
+
+    void *p = base + block->pos + pad;
+
+    block->pos += pad + size;
+
+    used_ += pad + size;
+
+    return p;
+  }
+
+ private:
+  size_t  blockSize_ { 16384 };
+  Block  *blocks_    { nullptr };
+  Dtor   *dtors_     { nullptr };
+  size_t  size_      { 0 };
+  size_t  used_      { 0 };
+};
+
+#endif
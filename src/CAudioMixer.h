@@ -0,0 +1,296 @@
+#ifndef CAudioMixer_H
+#define CAudioMixer_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Sound samples converted to the mixer format (mono signed 16 bit at
+// CAudioMixer::SAMPLE_RATE).
+class CAudioClip {
+ public:
+  using Samples = std::vector<int16_t>;
+
+ public:
+  CAudioClip() { }
+
+  const Samples &samples() const { return samples_; }
+
+  bool isEmpty() const { return samples_.empty(); }
+
+  // load PCM WAV (8 or 16 bit, any channels, rate dividing or multiple of the mixer rate)
+  bool load(const std::string &filename);
+
+ private:
+  Samples samples_;
+};
+
+//---
+
+// Offline audio renderer for headless sessions and exports (no device).
+//
+// Sounds played during a tick start at the beginning of that tick's block of
+// SAMPLES_PER_TICK samples, which mixTick appends to the in-memory PCM buffer
+// once the tick has been simulated, so the output is locked to the
+// simulation tick rather than wall clock time. Mixing is integer only
+// (voices summed and clamped) so the same sessions give bit identical PCM on
+// any machine. Like the SDL backend a fixed number of voices play at once
+// (the oldest is replaced).
+//
+// Nothing is mixed unless a mixer is attached to the App backend, so disabled
+// audio costs nothing.
+class CAudioMixer {
+ public:
+  enum { SAMPLE_RATE      = 44100 };
+  enum { TICK_RATE        = 60 };
+  enum { SAMPLES_PER_TICK = SAMPLE_RATE/TICK_RATE };
+  enum { MAX_VOICES       = 4 };
+
+  using Samples = std::vector<int16_t>;
+
+ public:
+  CAudioMixer() { }
+
+  const Samples &samples() const { return samples_; }
+
+  long numTicks() const { return long(samples_.size()/SAMPLES_PER_TICK); }
+
+  void clear() {
+    samples_.clear();
+
+    numVoices_ = 0;
+  }
+
+  // start clip at current tick
+  void play(const CAudioClip *clip) {
+    if (! clip || clip->isEmpty()) return;
+
+    if (numVoices_ == MAX_VOICES) {
+      std::copy(voices_ + 1, voices_ + MAX_VOICES, voices_);
+
+      --numVoices_;
+    }
+
+    Voice &voice = voices_[numVoices_++];
+
+    voice.clip = clip;
+    voice.pos  = 0;
+  }
+
+  // append current tick's samples
+  void mixTick() {
+    size_t start = samples_.size();
+
+    samples_.resize(start + SAMPLES_PER_TICK);
+
+    if (numVoices_ == 0) return;
+
+    int32_t mix[SAMPLES_PER_TICK] = {};
+
+    int n = 0;
+
+    for (int i = 0; i < numVoices_; ++i) {
+      Voice &voice = voices_[i];
+
+      const CAudioClip::Samples &clip = voice.clip->samples();
+
+      size_t num = std::min(size_t(SAMPLES_PER_TICK), clip.size() - voice.pos);
+
+      for (size_t j = 0; j < num; ++j)
+        mix[j] += clip[voice.pos + j];
+
+      voice.pos += num;
+
+      // keep unfinished voices (in play order)
+      if (voice.pos < clip.size())
+        voices_[n++] = voice;
+    }
+
+    numVoices_ = n;
+
+    int16_t *out = &samples_[start];
+
+    for (int j = 0; j < SAMPLES_PER_TICK; ++j)
+      out[j] = int16_t(std::min(std::max(mix[j], -32768), 32767));
+  }
+
+  // FNV-1a hash of samples (to compare runs)
+  uint64_t hash() const {
+    uint64_t h = 0xcbf29ce484222325ULL;
+
+    for (int16_t s : samples_) {
+      h = (h ^ uint8_t(s     ))*0x100000001b3ULL;
+      h = (h ^ uint8_t(s >> 8))*0x100000001b3ULL;
+    }
+
+    return h;
+  }
+
+  // write samples as 16 bit mono PCM WAV
+  bool writeWav(const std::string &filename) const {
+    FILE *fp = fopen(filename.c_str(), "wb");
+
+    if (! fp) {
+      std::cerr << "Error: Failed to write WAV '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    uint32_t dataSize   = uint32_t(samples_.size()*sizeof(int16_t));
+    uint32_t riffSize   = 36 + dataSize;
+    uint32_t fmtSize    = 16;
+    uint16_t format     = 1; // PCM
+    uint16_t channels   = 1;
+    uint32_t rate       = SAMPLE_RATE;
+    uint32_t byteRate   = SAMPLE_RATE*sizeof(int16_t);
+    uint16_t blockAlign = sizeof(int16_t);
+    uint16_t bits       = 16;
+
+    bool ok = (fwrite("RIFF"     , 4, 1, fp) == 1 &&
+               fwrite(&riffSize  , sizeof(riffSize  ), 1, fp) == 1 &&
+               fwrite("WAVEfmt " , 8, 1, fp) == 1 &&
+               fwrite(&fmtSize   , sizeof(fmtSize   ), 1, fp) == 1 &&
+               fwrite(&format    , sizeof(format    ), 1, fp) == 1 &&
+               fwrite(&channels  , sizeof(channels  ), 1, fp) == 1 &&
+               fwrite(&rate      , sizeof(rate      ), 1, fp) == 1 &&
+               fwrite(&byteRate  , sizeof(byteRate  ), 1, fp) == 1 &&
+               fwrite(&blockAlign, sizeof(blockAlign), 1, fp) == 1 &&
+               fwrite(&bits      , sizeof(bits      ), 1, fp) == 1 &&
+               fwrite("data"     , 4, 1, fp) == 1 &&
+               fwrite(&dataSize  , sizeof(dataSize  ), 1, fp) == 1 &&
+               (samples_.empty() ||
+                fwrite(&samples_[0], sizeof(int16_t), samples_.size(), fp) == samples_.size()));
+
+    fclose(fp);
+
+    if (! ok)
+      std::cerr << "Error: Failed to write WAV '" << filename << "'" << std::endl;
+
+    return ok;
+  }
+
+ private:
+  struct Voice {
+    const CAudioClip *clip { nullptr };
+    size_t            pos  { 0 };
+  };
+
+  Samples samples_;
+  Voice   voices_[MAX_VOICES];
+  int     numVoices_ { 0 };
+};
+
+//---
+
+inline bool
+CAudioClip::
+load(const std::string &filename)
+{
+  samples_.clear();
+
+  FILE *fp = fopen(filename.c_str(), "rb");
+
+  if (! fp) {
+    std::cerr << "Error: Failed to read sound '" << filename << "'" << std::endl;
+    return false;
+  }
+
+  std::vector<uint8_t> data;
+
+  uint8_t buffer[4096];
+
+  size_t n;
+
+  while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    data.insert(data.end(), buffer, buffer + n);
+
+  fclose(fp);
+
+  auto get16 = [&](size_t i) { return uint32_t(data[i] | (data[i + 1] << 8)); };
+  auto get32 = [&](size_t i) { return get16(i) | (get16(i + 2) << 16); };
+
+  bool ok = (data.size() >= 12 && memcmp(&data[0], "RIFF", 4) == 0 &&
+             memcmp(&data[8], "WAVE", 4) == 0);
+
+  uint32_t format = 0, channels = 0, rate = 0, bits = 0;
+
+  size_t dataPos = 0, dataSize = 0;
+
+  // fmt and data chunks (others skipped)
+  for (size_t i = 12; ok && i + 8 <= data.size(); ) {
+    uint32_t size = get32(i + 4);
+
+    if (i + 8 + size > data.size())
+      size = uint32_t(data.size() - i - 8);
+
+    if      (memcmp(&data[i], "fmt ", 4) == 0 && size >= 16) {
+      format   = get16(i +  8);
+      channels = get16(i + 10);
+      rate     = get32(i + 12);
+      bits     = get16(i + 22);
+    }
+    else if (memcmp(&data[i], "data", 4) == 0) {
+      dataPos  = i + 8;
+      dataSize = size;
+    }
+
+    i += 8 + size + (size & 1);
+  }
+
+  ok = (ok && format == 1 && channels > 0 && (bits == 8 || bits == 16) && rate > 0 &&
+        (CAudioMixer::SAMPLE_RATE % rate == 0 || rate % CAudioMixer::SAMPLE_RATE == 0) &&
+        dataPos > 0);
+
+  if (! ok) {
+    std::cerr << "Error: Unsupported sound '" << filename << "'" << std::endl;
+    return false;
+  }
+
+  // decode to mono 16 bit (channels averaged)
+  size_t frameSize = channels*(bits/8);
+  size_t numFrames = dataSize/frameSize;
+
+  Samples mono(numFrames);
+
+  for (size_t f = 0; f < numFrames; ++f) {
+    int32_t sum = 0;
+
+    for (uint32_t c = 0; c < channels; ++c) {
+      size_t i = dataPos + f*frameSize + c*(bits/8);
+
+      sum += (bits == 8 ? (int32_t(data[i]) - 128)*256 : int32_t(int16_t(get16(i))));
+    }
+
+    mono[f] = int16_t(sum/int32_t(channels));
+  }
+
+  // integer ratio resample (linear interpolation up, decimation down)
+  if (rate < uint32_t(CAudioMixer::SAMPLE_RATE)) {
+    int32_t r = int32_t(CAudioMixer::SAMPLE_RATE/rate);
+
+    samples_.resize(numFrames*r);
+
+    for (size_t f = 0; f < numFrames; ++f) {
+      int32_t s1 = mono[f];
+      int32_t s2 = (f + 1 < numFrames ? mono[f + 1] : 0);
+
+      for (int32_t k = 0; k < r; ++k)
+        samples_[f*r + k] = int16_t(s1 + (s2 - s1)*k/r);
+    }
+  }
+  else {
+    size_t r = rate/CAudioMixer::SAMPLE_RATE;
+
+    samples_.resize(numFrames/r);
+
+    for (size_t i = 0; i < samples_.size(); ++i)
+      samples_[i] = mono[i*r];
+  }
+
+  return true;
+}
+
+#endif
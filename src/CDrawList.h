@@ -0,0 +1,90 @@
+#ifndef CDrawList_H
+#define CDrawList_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+struct Image;
+
+// Recorded draw operations for one frame.
+//
+// Ops are stored by value (text in a fixed buffer) so a cleared list can be
+// refilled every tick without allocation once it has been reserve()d for the
+// largest frame (see CSpaceInvaders::maxDrawOps).
+class CDrawList {
+ public:
+  enum class Type {
+    IMAGE,
+    LEFT_TEXT,
+    CENTERED_TEXT,
+    RIGHT_TEXT,
+    RECT
+  };
+
+  struct Op {
+    Type     type  { Type::IMAGE };
+    int      x     { 0 };
+    int      y     { 0 };
+    Image   *image { nullptr };
+    int      w     { 0 };       // RECT size
+    int      h     { 0 };
+    uint32_t color { 0 };       // RECT colour (0xRRGGBB)
+    char     text[32];
+  };
+
+  using Ops = std::vector<Op>;
+
+ public:
+  CDrawList() { ops_.reserve(256); }
+
+  const Ops &ops() const { return ops_; }
+
+  void reserve(size_t n) { ops_.reserve(n); }
+
+  size_t capacity() const { return ops_.capacity(); }
+
+  void clear() { ops_.clear(); }
+
+  void addImage(int x, int y, Image *image) {
+    ops_.emplace_back();
+
+    Op &op = ops_.back();
+
+    op.x     = x;
+    op.y     = y;
+    op.image = image;
+  }
+
+  void addRect(int x, int y, int w, int h, uint32_t color) {
+    ops_.emplace_back();
+
+    Op &op = ops_.back();
+
+    op.type  = Type::RECT;
+    op.x     = x;
+    op.y     = y;
+    op.w     = w;
+    op.h     = h;
+    op.color = color;
+  }
+
+  void addText(Type type, int x, int y, const char *str) {
+    ops_.emplace_back();
+
+    Op &op = ops_.back();
+
+    op.type = type;
+    op.x    = x;
+    op.y    = y;
+
+    strncpy(op.text, str, sizeof(op.text) - 1);
+
+    op.text[sizeof(op.text) - 1] = '\0';
+  }
+
+ private:
+  Ops ops_;
+};
+
+#endif
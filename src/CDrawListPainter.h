@@ -0,0 +1,54 @@
+#ifndef CDrawListPainter_H
+#define CDrawListPainter_H
+
+#include <QColor>
+#include <QFontMetrics>
+#include <QImage>
+#include <QPainter>
+#include <CDrawList.h>
+#include <string>
+
+// Image referenced by draw list ops in the Qt backends (GUI and offscreen export)
+struct Image {
+  QImage      image;
+  std::string name;
+
+  Image(QImage image1, const std::string &name1) :
+   image(image1), name(name1) {
+  }
+};
+
+// Replays a CDrawList with a QPainter.
+//
+// Shared by the GUI (window) and export (offscreen QImage) backends so
+// exported video is painted exactly as the game is shown.
+class CDrawListPainter {
+ public:
+  static void paint(QPainter *painter, const CDrawList &drawList) {
+    QFontMetrics fm(painter->font());
+
+    painter->setPen(QColor(255,255,255));
+
+    for (const auto &op : drawList.ops()) {
+      switch (op.type) {
+        case CDrawList::Type::IMAGE:
+          painter->drawImage(op.x, op.y, op.image->image);
+          break;
+        case CDrawList::Type::LEFT_TEXT:
+          painter->drawText(op.x, op.y + fm.ascent(), op.text);
+          break;
+        case CDrawList::Type::CENTERED_TEXT:
+          painter->drawText(op.x - fm.width(op.text)/2, op.y + fm.ascent(), op.text);
+          break;
+        case CDrawList::Type::RIGHT_TEXT:
+          painter->drawText(op.x - fm.width(op.text), op.y + fm.ascent(), op.text);
+          break;
+        case CDrawList::Type::RECT:
+          painter->fillRect(op.x, op.y, op.w, op.h, QColor(QRgb(op.color)));
+          break;
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,517 @@
+#ifndef CFrameStream_H
+#define CFrameStream_H
+
+#include <CDrawList.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Delta compressed stream of CDrawList frames (spectator recording).
+//
+// Each frame is stored as the draw ops which changed since the previous frame.
+// Changed fields are flagged and positions are stored as zig-zag varint
+// deltas, so a tick in which only the formation moves costs a few bytes per
+// alien. A keyframe (delta against an empty frame) is written every
+// keyInterval frames so playback can start or resync there. Images are stored
+// by name once (IMAGE record) and referenced by id.
+//
+// File: "CQFS" magic, version byte, then records:
+//
+//   IMAGE : id, name length, name
+//   KEY   : tick, numOps, op changes against empty frame
+//   DELTA : tick, numOps, op changes against previous frame
+//
+// Op changes are (skip count, op diff) pairs up to numOps (a final skip may
+// cover the remaining unchanged ops). An op diff is a flags byte then the
+// flagged fields (type, image id, text, x delta, y delta, rect size, rect
+// colour).
+//
+// Ops are matched by index, so deltas stay small only while the op order is
+// stable. When an entity is removed (e.g. an alien dies) every later op shifts
+// down one slot and that frame's delta costs about as much as a keyframe;
+// later frames are small again.
+//
+// The reader checks every length against the bytes remaining (new ops cost at
+// least two bytes each) and stops with an error on a corrupt or truncated
+// stream.
+class CFrameStream {
+ public:
+  enum { VERSION = 2 };
+
+  enum { MAX_VARINT_BYTES = 10 }; // 64 bit value
+
+  enum RecordType : uint8_t {
+    REC_IMAGE = 1,
+    REC_KEY   = 2,
+    REC_DELTA = 3
+  };
+
+  enum OpFlags : uint8_t {
+    OP_TYPE  = (1<<0),
+    OP_IMAGE = (1<<1),
+    OP_TEXT  = (1<<2),
+    OP_X     = (1<<3),
+    OP_Y     = (1<<4),
+    OP_SIZE  = (1<<5),
+    OP_COLOR = (1<<6)
+  };
+
+  // draw op with image stored as stream id (0 for none)
+  struct Op {
+    uint8_t     type    { 0 };
+    uint32_t    imageId { 0 };
+    int32_t     x       { 0 };
+    int32_t     y       { 0 };
+    int32_t     w       { 0 };
+    int32_t     h       { 0 };
+    uint32_t    color   { 0 };
+    std::string text;
+  };
+
+  using Ops = std::vector<Op>;
+
+  static const char *magic() { return "CQFS"; }
+};
+
+//---
+
+class CFrameStreamWriter {
+ public:
+  using ImageName = std::function<std::string (const Image *)>;
+
+ public:
+  CFrameStreamWriter(const ImageName &imageName, int keyInterval=120) :
+   imageName_(imageName), keyInterval_(std::max(keyInterval, 1)) {
+  }
+
+ ~CFrameStreamWriter() { close(); }
+
+  CFrameStreamWriter(const CFrameStreamWriter &) = delete;
+  CFrameStreamWriter &operator=(const CFrameStreamWriter &) = delete;
+
+  bool open(const std::string &filename) {
+    close();
+
+    fp_ = fopen(filename.c_str(), "wb");
+
+    if (! fp_) {
+      std::cerr << "Error: Failed to write frame stream '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    fwrite(CFrameStream::magic(), 4, 1, fp_);
+    fputc(CFrameStream::VERSION, fp_);
+
+    bytes_     = 5;
+    numFrames_ = 0;
+
+    imageIds_.clear();
+    prev_    .clear();
+
+    return true;
+  }
+
+  void close() {
+    if (fp_) {
+      fclose(fp_);
+
+      fp_ = nullptr;
+    }
+  }
+
+  bool isOpen() const { return fp_; }
+
+  size_t bytesWritten() const { return bytes_; }
+  long   numFrames   () const { return numFrames_; }
+
+  void writeFrame(long tick, const CDrawList &drawList) {
+    if (! fp_) return;
+
+    buffer_.clear();
+
+    // convert ops (registering new images)
+    const CDrawList::Ops &ops = drawList.ops();
+
+    ops_.resize(ops.size());
+
+    for (size_t i = 0; i < ops.size(); ++i) {
+      const CDrawList::Op &op = ops[i];
+
+      CFrameStream::Op &sop = ops_[i];
+
+      sop.type    = uint8_t(op.type);
+      sop.imageId = (op.type == CDrawList::Type::IMAGE ? imageId(op.image) : 0);
+      sop.x       = op.x;
+      sop.y       = op.y;
+      sop.w       = op.w;
+      sop.h       = op.h;
+      sop.color   = op.color;
+
+      if (op.type != CDrawList::Type::IMAGE && op.type != CDrawList::Type::RECT)
+        sop.text = op.text;
+      else
+        sop.text.clear();
+    }
+
+    bool key = (numFrames_ % keyInterval_ == 0);
+
+    if (key)
+      prev_.clear();
+
+    buffer_.push_back(key ? CFrameStream::REC_KEY : CFrameStream::REC_DELTA);
+
+    writeVarint(uint64_t(tick));
+    writeVarint(ops_.size());
+
+    static const CFrameStream::Op emptyOp;
+
+    size_t skip = 0;
+
+    for (size_t i = 0; i < ops_.size(); ++i) {
+      const CFrameStream::Op &op   = ops_[i];
+      const CFrameStream::Op &prev = (i < prev_.size() ? prev_[i] : emptyOp);
+
+      uint8_t flags = 0;
+
+      if (op.type    != prev.type   ) flags |= CFrameStream::OP_TYPE;
+      if (op.imageId != prev.imageId) flags |= CFrameStream::OP_IMAGE;
+      if (op.text    != prev.text   ) flags |= CFrameStream::OP_TEXT;
+      if (op.x       != prev.x      ) flags |= CFrameStream::OP_X;
+      if (op.y       != prev.y      ) flags |= CFrameStream::OP_Y;
+      if (op.w       != prev.w || op.h != prev.h) flags |= CFrameStream::OP_SIZE;
+      if (op.color   != prev.color  ) flags |= CFrameStream::OP_COLOR;
+
+      if (! flags) {
+        ++skip;
+        continue;
+      }
+
+      writeVarint(skip);
+
+      skip = 0;
+
+      buffer_.push_back(flags);
+
+      if (flags & CFrameStream::OP_TYPE ) buffer_.push_back(op.type);
+      if (flags & CFrameStream::OP_IMAGE) writeVarint(op.imageId);
+
+      if (flags & CFrameStream::OP_TEXT) {
+        writeVarint(op.text.size());
+
+        buffer_.insert(buffer_.end(), op.text.begin(), op.text.end());
+      }
+
+      if (flags & CFrameStream::OP_X) writeVarint(zigZag(op.x - prev.x));
+      if (flags & CFrameStream::OP_Y) writeVarint(zigZag(op.y - prev.y));
+
+      if (flags & CFrameStream::OP_SIZE) {
+        writeVarint(zigZag(op.w));
+        writeVarint(zigZag(op.h));
+      }
+
+      if (flags & CFrameStream::OP_COLOR) writeVarint(op.color);
+    }
+
+    if (skip)
+      writeVarint(skip);
+
+    flushBuffer();
+
+    prev_.swap(ops_);
+
+    ++numFrames_;
+  }
+
+ private:
+  uint32_t imageId(const Image *image) {
+    auto p = imageIds_.find(image);
+
+    if (p != imageIds_.end())
+      return (*p).second;
+
+    uint32_t id = uint32_t(imageIds_.size() + 1);
+
+    imageIds_[image] = id;
+
+    // image definition precedes the frame using it
+    std::vector<uint8_t> frame;
+
+    frame.swap(buffer_);
+
+    std::string name = imageName_(image);
+
+    buffer_.push_back(CFrameStream::REC_IMAGE);
+
+    writeVarint(id);
+    writeVarint(name.size());
+
+    buffer_.insert(buffer_.end(), name.begin(), name.end());
+
+    flushBuffer();
+
+    buffer_.swap(frame);
+
+    return id;
+  }
+
+  static uint64_t zigZag(int64_t i) { return (uint64_t(i) << 1) ^ uint64_t(i >> 63); }
+
+  void writeVarint(uint64_t i) {
+    while (i >= 0x80) {
+      buffer_.push_back(uint8_t(i | 0x80));
+
+      i >>= 7;
+    }
+
+    buffer_.push_back(uint8_t(i));
+  }
+
+  void flushBuffer() {
+    fwrite(&buffer_[0], 1, buffer_.size(), fp_);
+
+    bytes_ += buffer_.size();
+
+    buffer_.clear();
+  }
+
+ private:
+  using ImageIds = std::map<const Image *, uint32_t>;
+
+  ImageName            imageName_;
+  int                  keyInterval_ { 120 };
+  FILE                *fp_          { nullptr };
+  ImageIds             imageIds_;
+  CFrameStream::Ops    prev_;
+  CFrameStream::Ops    ops_;
+  std::vector<uint8_t> buffer_;
+  size_t               bytes_       { 0 };
+  long                 numFrames_   { 0 };
+};
+
+//---
+
+class CFrameStreamReader {
+ public:
+  using ImageLoad = std::function<Image *(const std::string &)>;
+
+ public:
+  CFrameStreamReader(const ImageLoad &imageLoad) :
+   imageLoad_(imageLoad) {
+  }
+
+  CFrameStreamReader(const CFrameStreamReader &) = delete;
+  CFrameStreamReader &operator=(const CFrameStreamReader &) = delete;
+
+  bool open(const std::string &filename) {
+    FILE *fp = fopen(filename.c_str(), "rb");
+
+    if (! fp) {
+      std::cerr << "Error: Failed to read frame stream '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    data_.clear();
+
+    uint8_t buffer[65536];
+
+    size_t n;
+
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+      data_.insert(data_.end(), buffer, buffer + n);
+
+    fclose(fp);
+
+    if (data_.size() < 5 || memcmp(&data_[0], CFrameStream::magic(), 4) != 0 ||
+        data_[4] != CFrameStream::VERSION) {
+      std::cerr << "Error: Invalid frame stream '" << filename << "'" << std::endl;
+      data_.clear();
+      return false;
+    }
+
+    rewind();
+
+    return true;
+  }
+
+  // restart at first frame
+  void rewind() {
+    pos_   = 5;
+    error_ = false;
+
+    prev_.clear();
+  }
+
+  // stream was corrupt or truncated (no more frames are read)
+  bool hasError() const { return error_; }
+
+  // read next frame into drawList (false at end of stream)
+  bool readFrame(long &tick, CDrawList &drawList) {
+    for (;;) {
+      if (error_ || pos_ >= data_.size()) return false;
+
+      uint8_t type = data_[pos_++];
+
+      if (type == CFrameStream::REC_IMAGE) {
+        uint64_t id  = readVarint();
+        uint64_t len = readVarint();
+
+        // ids are assigned in sequence from 1
+        if (error_ || id == 0 || id > images_.size() + 1 || len > data_.size() - pos_)
+          return fail("bad image record");
+
+        std::string name(reinterpret_cast<const char *>(&data_[pos_]), len);
+
+        pos_ += len;
+
+        if (images_.size() <= id)
+          images_.resize(id + 1);
+
+        images_[id] = imageLoad_(name);
+
+        continue;
+      }
+
+      if (type != CFrameStream::REC_KEY && type != CFrameStream::REC_DELTA)
+        return fail("bad record type");
+
+      if (type == CFrameStream::REC_KEY)
+        prev_.clear();
+
+      tick = long(readVarint());
+
+      uint64_t numOps = readVarint();
+
+      // ops past the previous frame are diffed against an empty op, so each
+      // costs at least a skip count and a flags byte
+      if (error_ || numOps > prev_.size() + (data_.size() - pos_)/2)
+        return fail("bad op count");
+
+      prev_.resize(numOps);
+
+      for (size_t i = 0; i < numOps; ) {
+        uint64_t skip = readVarint(); // skip unchanged
+
+        if (error_ || skip > numOps - i)
+          return fail("bad op skip");
+
+        i += skip;
+
+        if (i >= numOps) break;
+
+        CFrameStream::Op &op = prev_[i++];
+
+        uint8_t flags = readByte();
+
+        if (flags & CFrameStream::OP_TYPE ) op.type    = readByte();
+        if (flags & CFrameStream::OP_IMAGE) op.imageId = uint32_t(readVarint());
+
+        if (flags & CFrameStream::OP_TEXT) {
+          uint64_t len = readVarint();
+
+          if (error_ || len > data_.size() - pos_)
+            return fail("bad text length");
+
+          op.text.assign(reinterpret_cast<const char *>(&data_[pos_]), len);
+
+          pos_ += len;
+        }
+
+        if (flags & CFrameStream::OP_X) op.x += int32_t(unZigZag(readVarint()));
+        if (flags & CFrameStream::OP_Y) op.y += int32_t(unZigZag(readVarint()));
+
+        if (flags & CFrameStream::OP_SIZE) {
+          op.w = int32_t(unZigZag(readVarint()));
+          op.h = int32_t(unZigZag(readVarint()));
+        }
+
+        if (flags & CFrameStream::OP_COLOR) op.color = uint32_t(readVarint());
+
+        if (error_)
+          return fail("truncated op");
+
+        if (op.type > uint8_t(CDrawList::Type::RECT))
+          return fail("bad op type");
+      }
+
+      // rebuild draw list from current ops
+      drawList.clear();
+
+      for (const auto &op : prev_) {
+        CDrawList::Type optype = CDrawList::Type(op.type);
+
+        if (optype == CDrawList::Type::IMAGE) {
+          Image *image = (op.imageId < images_.size() ? images_[op.imageId] : nullptr);
+
+          if (image)
+            drawList.addImage(op.x, op.y, image);
+        }
+        else if (optype == CDrawList::Type::RECT)
+          drawList.addRect(op.x, op.y, op.w, op.h, op.color);
+        else
+          drawList.addText(optype, op.x, op.y, op.text.c_str());
+      }
+
+      return true;
+    }
+  }
+
+ private:
+  static int64_t unZigZag(uint64_t i) { return int64_t(i >> 1) ^ -int64_t(i & 1); }
+
+  // report corrupt stream and stop reading
+  bool fail(const char *msg) {
+    std::cerr << "Error: Corrupt frame stream (" << msg << ")" << std::endl;
+
+    error_ = true;
+    pos_   = data_.size();
+
+    return false;
+  }
+
+  uint8_t readByte() {
+    if (pos_ < data_.size())
+      return data_[pos_++];
+
+    error_ = true;
+
+    return 0;
+  }
+
+  // sets error on truncated or over long (> 64 bit) varint
+  uint64_t readVarint() {
+    uint64_t i = 0;
+
+    for (int n = 0; n < CFrameStream::MAX_VARINT_BYTES; ++n) {
+      if (pos_ >= data_.size()) break;
+
+      uint8_t b = data_[pos_++];
+
+      i |= uint64_t(b & 0x7f) << (7*n);
+
+      if (! (b & 0x80)) return i;
+    }
+
+    error_ = true;
+
+    return 0;
+  }
+
+ private:
+  using Images = std::vector<Image *>;
+
+  ImageLoad            imageLoad_;
+  std::vector<uint8_t> data_;
+  size_t               pos_   { 0 };
+  bool                 error_ { false };
+  Images               images_;
+  CFrameStream::Ops    prev_;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef CInvadersObs_H
+#define CInvadersObs_H
+
+#include <CInvadersProtocol.h>
+
+#include <cstring>
+
+// Encodes a game's symbolic observation (ObsMsg, BaseRec per base, EntityRec
+// per alien, mystery and bullet) directly into a caller supplied buffer.
+//
+// Include after CSpaceInvaders.h.
+struct CInvadersObs {
+  using Protocol = CInvadersProtocol;
+
+  // largest encoded observation for any wave of levels
+  static size_t maxSize(const CLevels &levels) {
+    int numEntities = levels.maxAliens() + 1 + levels.maxPlayerBullets() +
+                      levels.maxAlienBullets();
+
+    return sizeof(Protocol::ObsMsg) + levels.maxBases()*sizeof(Protocol::BaseRec) +
+           numEntities*sizeof(Protocol::EntityRec);
+  }
+
+  // encoded size of game's current observation
+  static size_t size(const CSpaceInvaders &game) {
+    return sizeof(Protocol::ObsMsg) + game.getNumBases()*sizeof(Protocol::BaseRec) +
+           numEntities(game)*sizeof(Protocol::EntityRec);
+  }
+
+  static int numEntities(const CSpaceInvaders &game) {
+    return game.getAliens().size() + game.getMystery().size() +
+           game.getPlayerBullets().size() + game.getAlienBullets().size();
+  }
+
+  // encode observation into data (at least size(game) bytes), returns bytes written
+  static size_t encode(const CSpaceInvaders &game, int reward, char *data) {
+    char *p = data;
+
+    Protocol::ObsMsg obs;
+
+    obs.tick        = uint32_t(game.getTick());
+    obs.score       = game.getScore();
+    obs.reward      = reward;
+    obs.playerX     = int16_t(game.getPlayerPos().x);
+    obs.playerY     = int16_t(game.getPlayerPos().y);
+    obs.lives       = uint8_t(game.getLives());
+    obs.level       = uint8_t(game.getLevel());
+    obs.gameOver    = game.isGameOver();
+    obs.numBases    = uint8_t(game.getNumBases());
+    obs.numEntities = uint16_t(numEntities(game));
+
+    memcpy(p, &obs, sizeof(obs)); p += sizeof(obs);
+
+    for (int i = 0; i < game.getNumBases(); ++i) {
+      const Base &base = game.getBase(i);
+
+      Protocol::BaseRec rec;
+
+      rec.x = int16_t(base.getPos().x);
+      rec.y = int16_t(base.getPos().y);
+
+      for (int r = 0; r < 2; ++r)
+        for (int c = 0; c < 4; ++c)
+          rec.cellHits[r*4 + c] = uint8_t(base.getCellHits(r, c));
+
+      memcpy(p, &rec, sizeof(rec)); p += sizeof(rec);
+    }
+
+    auto encodeEntities = [&](const EntityStore &store, uint8_t kind) {
+      for (int i = 0; i < store.size(); ++i) {
+        Protocol::EntityRec rec;
+
+        rec.kind      = kind;
+        rec.type      = store.type[i];
+        rec.exploding = (store.explode[i] ? 1 : 0);
+        rec.pad       = 0;
+        rec.x         = int16_t(store.x[i]);
+        rec.y         = int16_t(store.y[i]);
+
+        memcpy(p, &rec, sizeof(rec)); p += sizeof(rec);
+      }
+    };
+
+    // aliens (live and exploding) in formation order
+    const AlienFormation &aliens = game.getAliens();
+
+    aliens.forEachPresent([&](int i) {
+      Protocol::EntityRec rec;
+
+      rec.kind      = Protocol::KIND_ALIEN;
+      rec.type      = uint8_t(aliens.type(i));
+      rec.exploding = (aliens.explode(i) ? 1 : 0);
+      rec.pad       = 0;
+      rec.x         = int16_t(aliens.x(i));
+      rec.y         = int16_t(aliens.y(i));
+
+      memcpy(p, &rec, sizeof(rec)); p += sizeof(rec);
+    });
+
+    encodeEntities(game.getMystery      (), Protocol::KIND_MYSTERY);
+    encodeEntities(game.getPlayerBullets(), Protocol::KIND_PLAYER_BULLET);
+    encodeEntities(game.getAlienBullets (), Protocol::KIND_ALIEN_BULLET);
+
+    return size_t(p - data);
+  }
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef CInvadersPolicy_H
+#define CInvadersPolicy_H
+
+#include <CInvadersProtocol.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+// Bot player: chooses CInvadersProtocol::Action bits for the game's current
+// state once per tick.
+//
+// Include after CSpaceInvaders.h.
+class CInvadersPolicy {
+ public:
+  virtual ~CInvadersPolicy() { }
+
+  // start of new episode
+  virtual void reset(uint64_t /*seed*/) { }
+
+  virtual uint8_t act(const CSpaceInvaders &game) = 0;
+};
+
+//---
+
+// Simple scripted bot: dodges alien bullets close above the ship, otherwise
+// moves under the formation's outermost column (left or right edge) nearest
+// the ship and fires continuously.
+class CScriptedPolicy : public CInvadersPolicy {
+ public:
+  using Protocol = CInvadersProtocol;
+
+ public:
+  CScriptedPolicy() { }
+
+  uint8_t act(const CSpaceInvaders &game) override {
+    const Point &pos = game.getPlayerPos();
+
+    // dodge nearest bullet which will arrive soon
+    const EntityStore &bullets = game.getAlienBullets();
+
+    int dodgeX = -1, dodgeDY = 1000;
+
+    for (int i = 0; i < bullets.size(); ++i) {
+      int dy = pos.y - bullets.y[i];
+
+      if (dy < 0 || dy > 160 || std::abs(bullets.x[i] - pos.x) > 40) continue;
+
+      if (dy < dodgeDY) {
+        dodgeX  = bullets.x[i];
+        dodgeDY = dy;
+      }
+    }
+
+    if (dodgeX >= 0) {
+      // move away from bullet (towards screen centre when level)
+      bool left = (dodgeX > pos.x || (dodgeX == pos.x && pos.x > SCREEN_WIDTH/2));
+
+      if (left && pos.x < 40) left = false;
+      if (! left && pos.x > SCREEN_WIDTH - 40) left = true;
+
+      return (left ? Protocol::ACTION_LEFT : Protocol::ACTION_RIGHT);
+    }
+
+    // target outermost column nearest ship (fewer columns means fewer edge drops)
+    const AlienFormation &aliens = game.getAliens();
+
+    int minX = -1, maxX = -1;
+
+    if (aliens.numAlive() > 0) {
+      minX = aliens.leftX ();
+      maxX = aliens.rightX();
+    }
+
+    int targetX = (std::abs(minX - pos.x) <= std::abs(maxX - pos.x) ? minX : maxX);
+
+    uint8_t action = Protocol::ACTION_FIRE;
+
+    if (targetX >= 0) {
+      // move under target
+      if      (targetX < pos.x - 4) action |= Protocol::ACTION_LEFT;
+      else if (targetX > pos.x + 4) action |= Protocol::ACTION_RIGHT;
+    }
+
+    return action;
+  }
+};
+
+#endif
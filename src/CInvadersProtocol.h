@@ -0,0 +1,93 @@
+#ifndef CInvadersProtocol_H
+#define CInvadersProtocol_H
+
+#include <cstdint>
+
+// Binary step protocol used by CInvadersServer.
+//
+// Every message is a MsgHeader followed by 'size' bytes of payload. All values
+// are little endian and structures are packed. A client may drive any number
+// of sessions over one connection and replies are sent in request order.
+// A step is one tick unless the host uses action repeat (CInvadersServer
+// -repeat), when the observation is of the step's final tick and its reward
+// covers all of the step's ticks.
+//
+//   MSG_CREATE (payload ResetMsg) : create session (header session ignored) -> MSG_OBS
+//   MSG_RESET  (payload ResetMsg) : restart session with seed               -> MSG_OBS
+//   MSG_STEP   (payload StepMsg)  : set actions and advance one step        -> MSG_OBS
+//   MSG_CLOSE  (no payload)       : destroy session                         -> no reply
+//
+//   MSG_OBS   : ObsMsg, then numBases BaseRec, then numEntities EntityRec
+//   MSG_ERROR : no payload (bad message or unknown session)
+struct CInvadersProtocol {
+  enum MsgType : uint8_t {
+    MSG_CREATE = 1,
+    MSG_RESET  = 2,
+    MSG_STEP   = 3,
+    MSG_CLOSE  = 4,
+    MSG_OBS    = 0x81,
+    MSG_ERROR  = 0xff
+  };
+
+  enum Action : uint8_t {
+    ACTION_LEFT  = 1,
+    ACTION_RIGHT = 2,
+    ACTION_FIRE  = 4
+  };
+
+  enum EntityKind : uint8_t {
+    KIND_ALIEN         = 0,
+    KIND_MYSTERY       = 1,
+    KIND_PLAYER_BULLET = 2,
+    KIND_ALIEN_BULLET  = 3
+  };
+
+  enum { MAX_PAYLOAD = 1024 };
+
+#pragma pack(push, 1)
+  struct MsgHeader {
+    uint8_t  type;
+    uint8_t  pad[3];
+    uint32_t session;
+    uint32_t size;
+  };
+
+  struct ResetMsg {
+    uint64_t seed;
+  };
+
+  struct StepMsg {
+    uint8_t actions; // Action bits
+  };
+
+  struct ObsMsg {
+    uint32_t tick;
+    int32_t  score;
+    int32_t  reward;      // score gained by this message's step(s)
+    int16_t  playerX;
+    int16_t  playerY;
+    uint8_t  lives;
+    uint8_t  level;
+    uint8_t  gameOver;
+    uint8_t  numBases;
+    uint16_t numEntities;
+  };
+
+  struct BaseRec {
+    int16_t x;
+    int16_t y;
+    uint8_t cellHits[8]; // 2 rows of 4 cells (4 hits = destroyed)
+  };
+
+  struct EntityRec {
+    uint8_t kind;        // EntityKind
+    uint8_t type;        // alien type
+    uint8_t exploding;
+    uint8_t pad;
+    int16_t x;
+    int16_t y;
+  };
+#pragma pack(pop)
+};
+
+#endif
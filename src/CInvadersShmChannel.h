@@ -0,0 +1,174 @@
+#ifndef CInvadersShmChannel_H
+#define CInvadersShmChannel_H
+
+#include <CInvadersProtocol.h>
+#include <CShmRing.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// POSIX shared memory channel between a game host and an agent process.
+//
+// The mapping holds two CShmRing's: actions (agent -> game) and observations
+// (game -> agent). The game encodes each observation straight into its ring
+// slot and the agent reads it in place, so a step costs no copies or syscalls
+// beyond a futex wake when the other side is asleep.
+//
+// Layout: ChannelHeader, action ring at actionOffset, observation ring at
+// obsOffset. Each observation slot is an ObsSlot header followed by the
+// CInvadersProtocol observation (ObsMsg, BaseRec's, EntityRec's).
+class CInvadersShmChannel {
+ public:
+  using Protocol = CInvadersProtocol;
+
+#pragma pack(push, 1)
+  struct ActionSlot {
+    uint8_t  type;    // Protocol::MSG_RESET, MSG_STEP or MSG_CLOSE
+    uint8_t  actions; // Protocol::Action bits (MSG_STEP)
+    uint8_t  pad[6];
+    uint64_t seed;    // MSG_RESET
+  };
+
+  struct ObsSlot {
+    uint32_t size;    // observation bytes following header
+    uint32_t pad;
+  };
+#pragma pack(pop)
+
+ private:
+  enum { MAGIC = 0x4d485343 }; // "CSHM"
+
+  struct ChannelHeader {
+    uint32_t magic;
+    uint32_t pad;
+    uint64_t size;
+    uint64_t actionOffset;
+    uint64_t obsOffset;
+  };
+
+ public:
+  CInvadersShmChannel() { }
+
+ ~CInvadersShmChannel() {
+    if (mem_)
+      munmap(mem_, size_);
+
+    if (owner_)
+      shm_unlink(name_.c_str());
+  }
+
+  CInvadersShmChannel(const CInvadersShmChannel &) = delete;
+  CInvadersShmChannel &operator=(const CInvadersShmChannel &) = delete;
+
+  // create channel (game host side), maxObsSize from CInvadersObs::maxSize
+  bool create(const std::string &name, uint32_t numSlots, size_t maxObsSize) {
+    size_t headerSize = alignSize(sizeof(ChannelHeader));
+    size_t actionSize = CShmRing::memorySize(numSlots, sizeof(ActionSlot));
+    size_t obsSize    = CShmRing::memorySize(numSlots, uint32_t(sizeof(ObsSlot) + maxObsSize));
+
+    size_t size = headerSize + actionSize + obsSize;
+
+    shm_unlink(name.c_str());
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (fd < 0 || ftruncate(fd, off_t(size)) != 0) {
+      std::cerr << "Error: Failed to create shared memory '" << name << "'" << std::endl;
+      if (fd >= 0) { close(fd); shm_unlink(name.c_str()); }
+      return false;
+    }
+
+    if (! map(fd, size)) {
+      shm_unlink(name.c_str());
+      return false;
+    }
+
+    name_  = name;
+    owner_ = true;
+
+    ChannelHeader *header = static_cast<ChannelHeader *>(mem_);
+
+    header->size         = size;
+    header->actionOffset = headerSize;
+    header->obsOffset    = headerSize + actionSize;
+
+    actions_     .init(mem(header->actionOffset), numSlots, sizeof(ActionSlot));
+    observations_.init(mem(header->obsOffset   ), numSlots, uint32_t(sizeof(ObsSlot) + maxObsSize));
+
+    // publish last so an agent never attaches to a half built channel
+    std::atomic_thread_fence(std::memory_order_release);
+
+    header->magic = MAGIC;
+
+    return true;
+  }
+
+  // open existing channel (agent side)
+  bool open(const std::string &name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+
+    struct stat fs;
+
+    if (fd < 0 || fstat(fd, &fs) != 0 || size_t(fs.st_size) < sizeof(ChannelHeader)) {
+      std::cerr << "Error: Failed to open shared memory '" << name << "'" << std::endl;
+      if (fd >= 0) close(fd);
+      return false;
+    }
+
+    if (! map(fd, size_t(fs.st_size)))
+      return false;
+
+    name_ = name;
+
+    const ChannelHeader *header = static_cast<const ChannelHeader *>(mem_);
+
+    if (header->magic != MAGIC || header->size != size_ ||
+        ! actions_     .attach(mem(header->actionOffset)) ||
+        ! observations_.attach(mem(header->obsOffset   ))) {
+      std::cerr << "Error: Bad shared memory channel '" << name << "'" << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  CShmRing &actions     () { return actions_; }
+  CShmRing &observations() { return observations_; }
+
+ private:
+  static size_t alignSize(size_t size) { return (size + 63) & ~size_t(63); }
+
+  bool map(int fd, size_t size) {
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (mem == MAP_FAILED) {
+      std::cerr << "Error: Failed to map shared memory" << std::endl;
+      return false;
+    }
+
+    mem_  = mem;
+    size_ = size;
+
+    return true;
+  }
+
+  void *mem(uint64_t offset) const { return static_cast<char *>(mem_) + offset; }
+
+ private:
+  std::string name_;
+  void       *mem_          { nullptr };
+  size_t      size_         { 0 };
+  bool        owner_        { false };
+  CShmRing    actions_;
+  CShmRing    observations_;
+};
+
+#endif
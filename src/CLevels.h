@@ -0,0 +1,378 @@
+#ifndef CLevels_H
+#define CLevels_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Definition of one wave (level) of aliens
+struct WaveDef {
+  enum { MAX_ROWS           = 16 };  // row types (later rows use the last type)
+  enum { MAX_FORMATION_ROWS = 256 };
+  enum { MAX_FORMATION_COLS = 256 };
+  enum { MAX_BASES          = 8 };
+
+  int32_t rows              { 5 };
+  int32_t cols              { 11 };
+  int32_t rowTypes[MAX_ROWS] = { 0, 1, 1, 2, 2 }; // alien type per row
+  int32_t rowY              { 110 };              // first row y
+  int32_t rowDY             { 60 };               // row spacing
+  int32_t colX              { 34 };               // first column x
+  int32_t colDX             { 68 };               // column spacing
+  int32_t numBases          { 4 };
+  int32_t baseX             { 98 };               // first base x
+  int32_t baseDX            { 196 };              // base spacing
+  int32_t baseY             { 840 };
+  int32_t speed             { 8 };                // formation speed (4ths of pixel per tick)
+  int32_t speedInc          { 1 };                // speed increase on each row drop
+  int32_t drop              { 24 };               // row drop at edge
+  int32_t playerBullets     { 5 };                // max player bullets in flight
+  int32_t alienBullets      { 5 };                // max alien bullets in flight
+  int32_t playerBulletSpeed { 32 };
+  int32_t alienBulletSpeed  { 8 };
+  int32_t fireDelay         { 8 };                // player ticks between shots
+  float   fireProb          { 0.01f };            // per alien per tick
+  float   mysteryProb       { 0.01f };            // per tick when no mystery alien
+};
+
+//---
+
+// Level (wave) definitions loaded from a text file.
+//
+// The parsed waves are cached in a binary file (<filename>.bin) which is used
+// directly while the text file's size and modification time (nanoseconds) are
+// unchanged. The cache is written to a temporary file and renamed into place
+// so concurrent loaders never see a partial cache.
+//
+// Text format (one wave per block, unspecified values use defaults):
+//
+//   # comment
+//   wave
+//     formation <rows> <cols>
+//     row_types <type> ...
+//     row_y <y> <dy>
+//     col_x <x> <dx>
+//     bases <n> <x> <dx> <y>
+//     speed <speed> <inc> <drop>
+//     bullets <player> <alien>
+//     bullet_speed <player> <alien>
+//     fire_delay <ticks>
+//     fire_prob <p>
+//     mystery_prob <p>
+//   end
+class CLevels {
+ private:
+  enum { CACHE_MAGIC   = 0x4c495143 }; // "CQIL"
+  enum { CACHE_VERSION = 3 };
+
+  struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t waveSize;
+    uint32_t numWaves;
+    int64_t  textSize;
+    int64_t  textTime; // modification time (nsecs)
+  };
+
+ public:
+  using Waves = std::vector<WaveDef>;
+
+ public:
+  CLevels() {
+    waves_.push_back(WaveDef());
+  }
+
+  // use waves built in code (e.g. generated benchmark waves)
+  void setWaves(const Waves &waves) {
+    if (waves.empty()) return;
+
+    waves_  = waves;
+    cached_ = false;
+  }
+
+  // load waves from text file (or its binary cache)
+  bool load(const std::string &filename) {
+    std::string cacheName = filename + ".bin";
+
+    struct stat textStat;
+
+    if (stat(filename.c_str(), &textStat) != 0) {
+      std::cerr << "Error: Missing levels file '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    if (readCache(cacheName, textStat)) {
+      cached_ = true;
+      return true;
+    }
+
+    Waves waves;
+
+    if (! parse(filename, waves))
+      return false;
+
+    waves_  = waves;
+    cached_ = false;
+
+    if (! writeCache(cacheName, textStat))
+      std::cerr << "Warning: Failed to write levels cache '" << cacheName << "'" << std::endl;
+
+    return true;
+  }
+
+  bool isCached() const { return cached_; }
+
+  int numWaves() const { return int(waves_.size()); }
+
+  // wave for level (1 based, levels past the last wave repeat it)
+  const WaveDef &wave(int level) const {
+    int i = std::min(std::max(level - 1, 0), numWaves() - 1);
+
+    return waves_[i];
+  }
+
+  // error message for invalid wave values (nullptr if valid)
+  static const char *checkWave(const WaveDef &wave) {
+    if (wave.rows < 1 || wave.rows > WaveDef::MAX_FORMATION_ROWS ||
+        wave.cols < 1 || wave.cols > WaveDef::MAX_FORMATION_COLS)
+      return "bad formation size";
+
+    if (wave.numBases < 0 || wave.numBases > WaveDef::MAX_BASES)
+      return "bad number of bases";
+
+    if (wave.speed < 1 || wave.speedInc < 0 || wave.drop < 0)
+      return "bad speed";
+
+    if (wave.playerBullets < 1 || wave.alienBullets < 1)
+      return "bad bullets";
+
+    if (wave.playerBulletSpeed < 1 || wave.alienBulletSpeed < 1)
+      return "bad bullet_speed";
+
+    if (wave.fireDelay < 1)
+      return "bad fire_delay";
+
+    return nullptr;
+  }
+
+  // largest counts over all waves (for fixed capacity allocation)
+  int maxAliens() const {
+    int n = 0;
+
+    for (const auto &wave : waves_)
+      n = std::max(n, wave.rows*wave.cols);
+
+    return n;
+  }
+
+  int maxBases() const {
+    int n = 0;
+
+    for (const auto &wave : waves_)
+      n = std::max(n, wave.numBases);
+
+    return n;
+  }
+
+  int maxPlayerBullets() const {
+    int n = 0;
+
+    for (const auto &wave : waves_)
+      n = std::max(n, wave.playerBullets);
+
+    return n;
+  }
+
+  int maxAlienBullets() const {
+    int n = 0;
+
+    for (const auto &wave : waves_)
+      n = std::max(n, wave.alienBullets);
+
+    return n;
+  }
+
+ private:
+  bool parse(const std::string &filename, Waves &waves) const {
+    std::ifstream is(filename);
+
+    if (! is) {
+      std::cerr << "Error: Failed to read levels file '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    std::string line;
+    int         lineNum = 0;
+    bool        inWave  = false;
+    WaveDef     wave;
+
+    auto error = [&](const std::string &msg) {
+      std::cerr << "Error: " << filename << ":" << lineNum << ": " << msg << std::endl;
+      return false;
+    };
+
+    while (std::getline(is, line)) {
+      ++lineNum;
+
+      std::string::size_type pos = line.find('#');
+
+      if (pos != std::string::npos)
+        line = line.substr(0, pos);
+
+      std::istringstream ls(line);
+
+      std::string key;
+
+      if (! (ls >> key)) continue;
+
+      if (key == "wave") {
+        if (inWave) return error("missing end");
+
+        wave   = WaveDef();
+        inWave = true;
+
+        continue;
+      }
+
+      if (! inWave) return error("'" + key + "' outside wave");
+
+      bool ok = true;
+
+      if      (key == "end") {
+        const char *msg = checkWave(wave);
+
+        if (msg) return error(msg);
+
+        waves.push_back(wave);
+
+        inWave = false;
+      }
+      else if (key == "formation")
+        ok = bool(ls >> wave.rows >> wave.cols);
+      else if (key == "row_types") {
+        int i = 0, type;
+
+        while (i < WaveDef::MAX_ROWS && ls >> type)
+          wave.rowTypes[i++] = type;
+
+        ok = (i > 0);
+      }
+      else if (key == "row_y")
+        ok = bool(ls >> wave.rowY >> wave.rowDY);
+      else if (key == "col_x")
+        ok = bool(ls >> wave.colX >> wave.colDX);
+      else if (key == "bases")
+        ok = bool(ls >> wave.numBases >> wave.baseX >> wave.baseDX >> wave.baseY);
+      else if (key == "speed")
+        ok = bool(ls >> wave.speed >> wave.speedInc >> wave.drop);
+      else if (key == "bullets")
+        ok = bool(ls >> wave.playerBullets >> wave.alienBullets);
+      else if (key == "bullet_speed")
+        ok = bool(ls >> wave.playerBulletSpeed >> wave.alienBulletSpeed);
+      else if (key == "fire_delay")
+        ok = bool(ls >> wave.fireDelay);
+      else if (key == "fire_prob")
+        ok = bool(ls >> wave.fireProb);
+      else if (key == "mystery_prob")
+        ok = bool(ls >> wave.mysteryProb);
+      else
+        return error("unknown key '" + key + "'");
+
+      if (! ok) return error("bad value(s) for '" + key + "'");
+    }
+
+    if (inWave) return error("missing end");
+
+    if (waves.empty()) return error("no waves");
+
+    return true;
+  }
+
+  static int64_t modifyTime(const struct stat &textStat) {
+    return int64_t(textStat.st_mtim.tv_sec)*1000000000 + textStat.st_mtim.tv_nsec;
+  }
+
+  bool readCache(const std::string &filename, const struct stat &textStat) {
+    FILE *fp = fopen(filename.c_str(), "rb");
+    if (! fp) return false;
+
+    // wave count must match file size before it is used to allocate
+    struct stat cacheStat;
+
+    if (fstat(fileno(fp), &cacheStat) != 0) {
+      fclose(fp);
+      return false;
+    }
+
+    CacheHeader header;
+
+    bool ok = (fread(&header, sizeof(header), 1, fp) == 1 &&
+               header.magic    == CACHE_MAGIC && header.version == CACHE_VERSION &&
+               header.waveSize == sizeof(WaveDef) && header.numWaves > 0 &&
+               header.textSize == int64_t(textStat.st_size) &&
+               header.textTime == modifyTime(textStat) &&
+               uint64_t(cacheStat.st_size) ==
+                 sizeof(header) + uint64_t(header.numWaves)*sizeof(WaveDef));
+
+    if (ok) {
+      Waves waves(header.numWaves);
+
+      ok = (fread(&waves[0], sizeof(WaveDef), waves.size(), fp) == waves.size());
+
+      for (size_t i = 0; ok && i < waves.size(); ++i)
+        ok = ! checkWave(waves[i]);
+
+      if (ok)
+        waves_.swap(waves);
+    }
+
+    fclose(fp);
+
+    return ok;
+  }
+
+  bool writeCache(const std::string &filename, const struct stat &textStat) const {
+    std::string tempName = filename + "." + std::to_string(getpid()) + ".tmp";
+
+    FILE *fp = fopen(tempName.c_str(), "wb");
+    if (! fp) return false;
+
+    CacheHeader header;
+
+    header.magic    = CACHE_MAGIC;
+    header.version  = CACHE_VERSION;
+    header.waveSize = sizeof(WaveDef);
+    header.numWaves = uint32_t(waves_.size());
+    header.textSize = int64_t(textStat.st_size);
+    header.textTime = modifyTime(textStat);
+
+    bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1 &&
+               fwrite(&waves_[0], sizeof(WaveDef), waves_.size(), fp) == waves_.size());
+
+    ok = (fclose(fp) == 0) && ok;
+
+    // readers see either the old cache or the complete new one
+    if (ok)
+      ok = (rename(tempName.c_str(), filename.c_str()) == 0);
+
+    if (! ok)
+      remove(tempName.c_str());
+
+    return ok;
+  }
+
+ private:
+  Waves waves_;
+  bool  cached_ { false };
+};
+
+#endif
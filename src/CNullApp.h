@@ -0,0 +1,72 @@
+#ifndef CNullApp_H
+#define CNullApp_H
+
+// Headless backend for CSpaceInvaders (nothing is drawn).
+//
+// Sounds are ignored unless an offline mixer is attached to the calling
+// thread (setMixer), in which case they are mixed into its PCM buffer (clips
+// are loaded on first play).
+//
+// Include before CSpaceInvaders.h in tools that run games without a display.
+
+#include <CAudioMixer.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct Image { };
+
+struct Sound {
+  std::string    filename;
+  CAudioClip     clip;
+  std::once_flag loaded;
+
+  Sound(const std::string &filename1) :
+   filename(filename1) {
+  }
+};
+
+class App {
+ public:
+  static Image *loadImage(const char *) { static Image image; return &image; }
+
+  // not thread safe (sounds are loaded once by Assets)
+  static Sound *loadSound(const char *filename) {
+    auto &sound = sounds_[filename];
+
+    if (! sound)
+      sound = std::make_unique<Sound>(filename);
+
+    return sound.get();
+  }
+
+  static void drawImage(int, int, Image *) { }
+
+  static void fillRect(int, int, int, int, uint32_t) { }
+
+  static void drawLeftText    (int, int, const char *) { }
+  static void drawCenteredText(int, int, const char *) { }
+  static void drawRightText   (int, int, const char *) { }
+
+  static void playSound(Sound *sound) {
+    if (! mixer_) return;
+
+    std::call_once(sound->loaded, [sound]() { sound->clip.load(sound->filename); });
+
+    mixer_->play(&sound->clip);
+  }
+
+  // mixer for sounds played by this thread's games (nullptr for none)
+  static void setMixer(CAudioMixer *mixer) { mixer_ = mixer; }
+
+ private:
+  using SoundList = std::map<std::string, std::unique_ptr<Sound>>;
+
+  static inline SoundList                 sounds_;
+  static inline thread_local CAudioMixer *mixer_ { nullptr };
+};
+
+#endif
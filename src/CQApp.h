@@ -0,0 +1,58 @@
+#ifndef CQApp_H
+#define CQApp_H
+
+#include <CDrawListPainter.h>
+#include <CSPSCQueue.h>
+#include <map>
+#include <string>
+
+class CQSound;
+
+struct Sound {
+  CQSound *sound;
+
+  Sound(CQSound *sound1) :
+   sound(sound1) {
+  }
+};
+
+// Qt backend for CSpaceInvaders.
+//
+// Draw calls are recorded into the current draw list (simulation thread) and
+// replayed by CDrawListPainter (GUI thread). Sounds are queued and played by playSounds().
+class App {
+ public:
+  static Image *loadImage(const char *filename);
+
+  static Sound *loadSound(const char *filename);
+
+  // free all loaded images and sounds
+  static void term();
+
+  static void drawImage(int x, int y, Image *image);
+
+  // solid rect, color is 0xRRGGBB
+  static void fillRect(int x, int y, int w, int h, uint32_t color);
+
+  static void drawLeftText    (int x, int y, const char *str);
+  static void drawCenteredText(int x, int y, const char *str);
+  static void drawRightText   (int x, int y, const char *str);
+
+  static void playSound(Sound *sound);
+
+  static void setDrawList(CDrawList *drawList) { drawList_ = drawList; }
+
+  static void playSounds();
+
+ private:
+  typedef std::map<std::string,Image *> ImageList;
+  typedef std::map<std::string,Sound *> SoundList;
+  typedef CSPSCQueue<Sound *,64>        SoundQueue;
+
+  static ImageList  images_;
+  static SoundList  sounds_;
+  static CDrawList *drawList_;
+  static SoundQueue soundQueue_;
+};
+
+#endif
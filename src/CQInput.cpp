@@ -0,0 +1,208 @@
+#include <CQInput.h>
+#include <CQStartup.h>
+#include <QKeyEvent>
+
+#include <SDL2/SDL.h>
+
+namespace {
+
+const int AXIS_DEAD_ZONE = 8000;
+
+}
+
+CQInput::
+CQInput()
+{
+  timer_.start();
+}
+
+CQInput::
+~CQInput()
+{
+  closeController();
+
+  if (sdlInit_)
+    SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+}
+
+void
+CQInput::
+initController()
+{
+  if (isControllerInit()) return;
+
+  if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) != 0) {
+    sdlFailed_ = true;
+    return;
+  }
+
+  sdlInit_ = true;
+
+  openController();
+
+  CQStartup::mark("game controllers ready");
+}
+
+double
+CQInput::
+elapsed() const
+{
+  return timer_.nsecsElapsed()/1e9;
+}
+
+bool
+CQInput::
+keyPress(QKeyEvent *e)
+{
+  return setKey(e, true);
+}
+
+bool
+CQInput::
+keyRelease(QKeyEvent *e)
+{
+  return setKey(e, false);
+}
+
+bool
+CQInput::
+releaseKeys()
+{
+  if (! keys_.left && ! keys_.right && ! keys_.fire)
+    return false;
+
+  keys_.left  = false;
+  keys_.right = false;
+  keys_.fire  = false;
+
+  keys_.time = elapsed();
+  keys_.seq  = ++seq_;
+
+  return true;
+}
+
+bool
+CQInput::
+setKey(QKeyEvent *e, bool pressed)
+{
+  bool *flag = nullptr;
+
+  if      (e->key() == Qt::Key_Left ) flag = &keys_.left;
+  else if (e->key() == Qt::Key_Right) flag = &keys_.right;
+  else if (e->key() == Qt::Key_Space) flag = &keys_.fire;
+
+  if (! flag)
+    return false;
+
+  if (e->isAutoRepeat())
+    return true;
+
+  if (*flag != pressed) {
+    *flag = pressed;
+
+    keys_.time = elapsed();
+    keys_.seq  = ++seq_;
+  }
+
+  return true;
+}
+
+CQInput::State
+CQInput::
+sample()
+{
+  State state = keys_;
+
+  state.left  = state.left  || pad_.left;
+  state.right = state.right || pad_.right;
+  state.fire  = state.fire  || pad_.fire;
+
+  // keep time and sequence of the latest change in the combined state
+  bool changed = (state.left  != state_.left  ||
+                  state.right != state_.right ||
+                  state.fire  != state_.fire);
+
+  if      (state.seq > state_.seq) {
+    // new key events since last sample
+  }
+  else if (changed) {
+    // gamepad change
+    state.time = elapsed();
+    state.seq  = ++seq_;
+  }
+  else {
+    state.time = state_.time;
+    state.seq  = state_.seq;
+  }
+
+  state_ = state;
+
+  return state_;
+}
+
+void
+CQInput::
+openController()
+{
+  if (! sdlInit_ || controller_) return;
+
+  for (int i = 0; i < SDL_NumJoysticks(); ++i) {
+    if (! SDL_IsGameController(i)) continue;
+
+    controller_ = SDL_GameControllerOpen(i);
+
+    if (controller_)
+      break;
+  }
+}
+
+void
+CQInput::
+closeController()
+{
+  if (controller_) {
+    SDL_GameControllerClose(controller_);
+
+    controller_ = nullptr;
+  }
+}
+
+void
+CQInput::
+poll()
+{
+  if (! sdlInit_) return;
+
+  SDL_GameControllerUpdate();
+
+  if (controller_ && ! SDL_GameControllerGetAttached(controller_)) {
+    closeController();
+
+    pad_ = State();
+  }
+
+  // look for a (re)attached controller about once a second
+  if (! controller_) {
+    double t = elapsed();
+
+    if (t < openTime_) return;
+
+    openTime_ = t + 1.0;
+
+    SDL_JoystickUpdate();
+
+    openController();
+
+    if (! controller_) return;
+  }
+
+  auto button = [&](SDL_GameControllerButton b) {
+    return SDL_GameControllerGetButton(controller_, b) != 0;
+  };
+
+  int axis = SDL_GameControllerGetAxis(controller_, SDL_CONTROLLER_AXIS_LEFTX);
+
+  pad_.left  = (button(SDL_CONTROLLER_BUTTON_DPAD_LEFT ) || axis < -AXIS_DEAD_ZONE);
+  pad_.right = (button(SDL_CONTROLLER_BUTTON_DPAD_RIGHT) || axis >  AXIS_DEAD_ZONE);
+  pad_.fire  = (button(SDL_CONTROLLER_BUTTON_A) || button(SDL_CONTROLLER_BUTTON_X));
+}
@@ -0,0 +1,77 @@
+#ifndef CQInput_H
+#define CQInput_H
+
+#include <QElapsedTimer>
+
+class QKeyEvent;
+
+struct _SDL_GameController;
+
+// Held key and gamepad state sampled once per tick.
+//
+// Key state is tracked from Qt press/release events (auto repeat ignored) and
+// merged with the first SDL game controller (d-pad, left stick and A/X buttons).
+// Releases are not delivered once the window loses focus, so the owner must
+// call releaseKeys() on focus out.
+//
+// SDL init is not thread safe, so the game controller subsystem is only
+// initialized when the owner calls initController() (after background audio
+// init has finished); until then poll() does nothing.
+class CQInput {
+ public:
+  struct State {
+    bool   left  { false };
+    bool   right { false };
+    bool   fire  { false };
+    double time  { 0.0 }; // time (secs) of last state change
+    int    seq   { 0 };   // sequence number of last state change
+  };
+
+ public:
+  CQInput();
+ ~CQInput();
+
+  // elapsed secs since input started (common time base for all stamps)
+  double elapsed() const;
+
+  bool keyPress  (QKeyEvent *e);
+  bool keyRelease(QKeyEvent *e);
+
+  // release all held keys (window lost focus), returns true if any were held
+  bool releaseKeys();
+
+  // current key state (without gamepad)
+  const State &keys() const { return keys_; }
+
+  const QElapsedTimer &timer() const { return timer_; }
+
+  // init SDL game controller support (once, GUI thread)
+  void initController();
+
+  bool isControllerInit() const { return sdlInit_ || sdlFailed_; }
+
+  // update gamepad state (call regularly)
+  void poll();
+
+  // combined key and gamepad state
+  State sample();
+
+ private:
+  bool setKey(QKeyEvent *e, bool pressed);
+
+  void openController();
+  void closeController();
+
+ private:
+  QElapsedTimer        timer_;
+  State                keys_;
+  State                pad_;
+  State                state_;
+  _SDL_GameController *controller_ { nullptr };
+  bool                 sdlInit_    { false };
+  bool                 sdlFailed_  { false };
+  double               openTime_   { 0.0 };
+  int                  seq_        { 0 };
+};
+
+#endif
@@ -11,8 +11,10 @@ QMAKE_CXXFLAGS += -std=c++17
 INCLUDEPATH += .
 
 # Input
-HEADERS += CQSpaceInvaders.h CSpaceInvaders.h CQSound.h CSDLSound.h
-SOURCES += CQSpaceInvaders.cpp CQSound.cpp CSDLSound.cpp
+HEADERS += CQSpaceInvaders.h CSpaceInvaders.h CSpriteMasks.h CLevels.h CArena.h CQApp.h CQInput.h CQLatency.h CQStartup.h \
+           CQSimThread.h CDrawList.h CDrawListPainter.h CTripleBuffer.h CSPSCQueue.h CFrameStream.h CReplay.h CInvadersPolicy.h CSearchPolicy.h CQSound.h CSDLSound.h
+SOURCES += CQSpaceInvaders.cpp CQInput.cpp CQLatency.cpp CQStartup.cpp CQSimThread.cpp \
+           CQSound.cpp CSDLSound.cpp
 
 DESTDIR     = ../bin
 OBJECTS_DIR = ../obj
@@ -0,0 +1,154 @@
+#include <CQLatency.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+void
+CQLatency::
+inputArrived(int seq, double t)
+{
+  if (seq <= lastSeq_) return;
+
+  lastSeq_ = seq;
+
+  Event event;
+
+  event.seq    = seq;
+  event.arrive = t;
+
+  events_.push_back(event);
+}
+
+void
+CQLatency::
+tickConsumed(int seq, double t)
+{
+  // tick consumes the latest state so all earlier events are included
+  for (auto &event : events_) {
+    if (event.seq > seq) break;
+
+    if (event.tick < 0.0) {
+      event.tick = t;
+
+      stages_[INPUT_TICK].add(event.tick - event.arrive);
+    }
+  }
+}
+
+void
+CQLatency::
+framePainted(int seq, double t)
+{
+  for (auto &event : events_) {
+    if (event.seq > seq) break;
+
+    if (event.tick >= 0.0 && event.paint < 0.0) {
+      event.paint = t;
+
+      stages_[TICK_PAINT].add(event.paint - event.tick);
+    }
+  }
+}
+
+void
+CQLatency::
+frameFlushed(double t)
+{
+  while (! events_.empty() && events_.front().paint >= 0.0) {
+    const Event &event = events_.front();
+
+    stages_[PAINT_FLUSH].add(t - event.paint);
+    stages_[TOTAL      ].add(t - event.arrive);
+
+    events_.pop_front();
+  }
+}
+
+void
+CQLatency::
+report(std::ostream &os) const
+{
+  static const char *names[NUM_STAGES] = {
+    "input->tick", "tick->paint", "paint->flush", "input->flush" };
+
+  os << "Latency (ms)" << std::endl;
+
+  for (int i = 0; i < NUM_STAGES; ++i)
+    stages_[i].print(os, names[i]);
+}
+
+//------
+
+void
+CQLatency::Histogram::
+add(double secs)
+{
+  double ms = 1000.0*secs;
+
+  int i = std::min(std::max(int(ms), 0), int(NUM_BUCKETS));
+
+  ++buckets_[i];
+
+  ++count_;
+
+  sum_ += ms;
+  max_  = std::max(max_, ms);
+}
+
+double
+CQLatency::Histogram::
+percentile(double p) const
+{
+  int n = int(p*count_);
+
+  int sum = 0;
+
+  for (int i = 0; i <= NUM_BUCKETS; ++i) {
+    sum += buckets_[i];
+
+    if (sum > n)
+      return i + 1;
+  }
+
+  return max_;
+}
+
+void
+CQLatency::Histogram::
+print(std::ostream &os, const char *name) const
+{
+  os << std::fixed << std::setprecision(2);
+
+  os << "  " << std::left << std::setw(14) << name << std::right <<
+        " count " << std::setw(6) << count_;
+
+  if (count_ == 0) {
+    os << std::endl;
+    return;
+  }
+
+  os << " mean " << std::setw(7) << sum_/count_ <<
+        " p50 <" << std::setw(4) << int(percentile(0.50)) <<
+        " p90 <" << std::setw(4) << int(percentile(0.90)) <<
+        " p99 <" << std::setw(4) << int(percentile(0.99)) <<
+        " max " << std::setw(7) << max_ << std::endl;
+
+  int maxCount = *std::max_element(buckets_, buckets_ + NUM_BUCKETS + 1);
+
+  for (int i = 0; i <= NUM_BUCKETS; ++i) {
+    if (buckets_[i] == 0) continue;
+
+    int len = (40*buckets_[i] + maxCount - 1)/maxCount;
+
+    os << "    ";
+
+    if (i < NUM_BUCKETS)
+      os << std::setw(3) << i << "-" << std::setw(3) << std::left << i + 1 << std::right;
+    else
+      os << std::setw(3) << i << "+   ";
+
+    os << " " << std::setw(6) << buckets_[i] << " " << std::string(len, '#') << std::endl;
+  }
+}
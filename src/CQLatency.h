@@ -0,0 +1,68 @@
+#ifndef CQLatency_H
+#define CQLatency_H
+
+#include <deque>
+#include <iosfwd>
+
+// Input to display latency measurement.
+//
+// Each input event is tagged with a sequence number when it arrives and followed
+// through the tick that consumes it, the paint that first reflects it and the
+// flush of that frame. A histogram (1ms buckets) is kept for each stage.
+class CQLatency {
+ public:
+  enum Stage {
+    INPUT_TICK,
+    TICK_PAINT,
+    PAINT_FLUSH,
+    TOTAL,
+    NUM_STAGES
+  };
+
+ public:
+  CQLatency() { }
+
+  void inputArrived(int seq, double t);
+
+  void tickConsumed(int seq, double t);
+
+  void framePainted(int seq, double t);
+
+  void frameFlushed(double t);
+
+  void report(std::ostream &os) const;
+
+ private:
+  struct Event {
+    int    seq    { 0 };
+    double arrive { 0.0 };
+    double tick   { -1.0 };
+    double paint  { -1.0 };
+  };
+
+  class Histogram {
+   public:
+    enum { NUM_BUCKETS = 100 };
+
+    void add(double secs);
+
+    void print(std::ostream &os, const char *name) const;
+
+   private:
+    double percentile(double p) const;
+
+   private:
+    int    buckets_[NUM_BUCKETS + 1] = {}; // last bucket is overflow
+    int    count_ { 0 };
+    double sum_   { 0.0 };
+    double max_   { 0.0 };
+  };
+
+  using Events = std::deque<Event>;
+
+  Events    events_;
+  int       lastSeq_ { 0 };
+  Histogram stages_[NUM_STAGES];
+};
+
+#endif
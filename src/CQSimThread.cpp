@@ -0,0 +1,234 @@
+#include <CQSimThread.h>
+#include <CQApp.h>
+#include <CFrameStream.h>
+#include <CReplay.h>
+#include <CSpaceInvaders.h>
+#include <CInvadersPolicy.h>
+
+#include <chrono>
+
+CQSimThread::
+CQSimThread(CSpaceInvaders *invaders, const QElapsedTimer &timer) :
+ invaders_(invaders), timer_(timer)
+{
+  // size render buffers for the largest frame so ticks never allocate
+  int maxOps = invaders_->maxDrawOps();
+
+  for (int i = 0; i < 3; ++i)
+    renderBuffer_.buffer(i).drawList.reserve(maxOps);
+}
+
+CQSimThread::
+~CQSimThread()
+{
+  stop();
+}
+
+void
+CQSimThread::
+start()
+{
+  if (thread_.joinable()) return;
+
+  stop_ = false;
+
+  thread_ = std::thread([this]() { run(); });
+}
+
+void
+CQSimThread::
+stop()
+{
+  if (! thread_.joinable()) return;
+
+  stop_ = true;
+
+  thread_.join();
+}
+
+void
+CQSimThread::
+setInput(const CQInput::State &state)
+{
+  Command command;
+
+  command.type  = Command::Type::INPUT;
+  command.input = state;
+
+  sendCommand(command);
+}
+
+void
+CQSimThread::
+pause()
+{
+  Command command;
+
+  command.type = Command::Type::PAUSE;
+
+  sendCommand(command);
+}
+
+void
+CQSimThread::
+restart()
+{
+  Command command;
+
+  command.type = Command::Type::RESTART;
+
+  sendCommand(command);
+}
+
+void
+CQSimThread::
+sendCommand(const Command &command)
+{
+  // queue only fills if simulation has stalled, so just drop
+  (void) commands_.push(command);
+}
+
+void
+CQSimThread::
+run()
+{
+  using Clock = std::chrono::steady_clock;
+
+  const auto period = std::chrono::nanoseconds(1000000000/60);
+
+  auto next = Clock::now();
+
+  while (! stop_) {
+    tick();
+
+    next += period;
+
+    auto now = Clock::now();
+
+    // don't try to catch up after a long stall
+    if (next < now - 4*period)
+      next = now;
+
+    std::this_thread::sleep_until(next);
+  }
+}
+
+void
+CQSimThread::
+tick()
+{
+  Command command;
+
+  uint8_t replayFlags = 0;
+
+  while (commands_.pop(command)) {
+    switch (command.type) {
+      case Command::Type::INPUT: {
+        Input input;
+
+        input.left  = command.input.left;
+        input.right = command.input.right;
+        input.fire  = command.input.fire;
+        input.time  = command.input.time;
+        input.seq   = command.input.seq;
+
+        invaders_->setInput(input);
+
+        break;
+      }
+      case Command::Type::PAUSE:
+        invaders_->pause();
+
+        replayFlags ^= CReplay::PAUSE;
+
+        break;
+      case Command::Type::RESTART:
+        invaders_->restart();
+
+        replayFlags |= CReplay::RESTART;
+
+        break;
+    }
+  }
+
+  // fast forward advances several ticks and only renders the last
+  int n = speed_;
+
+  for (int i = 0; i < n; ++i) {
+    advance(replayFlags);
+
+    replayFlags = 0;
+  }
+
+  render();
+}
+
+void
+CQSimThread::
+advance(uint8_t replayFlags)
+{
+  if (policy_) {
+    if (invaders_->isGameOver()) {
+      invaders_->restart();
+
+      replayFlags |= CReplay::RESTART;
+    }
+
+    uint8_t action = policy_->act(*invaders_);
+
+    Input input = invaders_->input();
+
+    input.left  = (action & CInvadersProtocol::ACTION_LEFT );
+    input.right = (action & CInvadersProtocol::ACTION_RIGHT);
+    input.fire  = (action & CInvadersProtocol::ACTION_FIRE );
+
+    invaders_->setInput(input);
+  }
+
+  if (replay_) {
+    const Input &input = invaders_->input();
+
+    if (input.left ) replayFlags |= CReplay::LEFT;
+    if (input.right) replayFlags |= CReplay::RIGHT;
+    if (input.fire ) replayFlags |= CReplay::FIRE;
+
+    replay_->addTick(replayFlags);
+  }
+
+  // stamp first tick to see each input (later snapshots may be dropped)
+  if (invaders_->input().seq != consumeSeq_) {
+    consumeSeq_  = invaders_->input().seq;
+    consumeTime_ = timer_.nsecsElapsed()/1e9;
+  }
+
+  invaders_->update();
+
+  if (replay_)
+    replay_->addHash(invaders_->stateHash());
+
+  ++tick_;
+}
+
+void
+CQSimThread::
+render()
+{
+  CQRenderState &state = renderBuffer_.back();
+
+  state.tick        = tick_;
+  state.inputSeq    = consumeSeq_;
+  state.consumeTime = consumeTime_;
+
+  state.drawList.clear();
+
+  App::setDrawList(&state.drawList);
+
+  invaders_->draw();
+
+  App::setDrawList(nullptr);
+
+  if (stream_)
+    stream_->writeFrame(state.tick, state.drawList);
+
+  renderBuffer_.publish();
+}
@@ -0,0 +1,107 @@
+#ifndef CQSimThread_H
+#define CQSimThread_H
+
+#include <CQInput.h>
+#include <CDrawList.h>
+#include <CTripleBuffer.h>
+#include <CSPSCQueue.h>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+class CSpaceInvaders;
+class CFrameStreamWriter;
+class CReplay;
+class CInvadersPolicy;
+
+// Immutable render snapshot published once per tick
+struct CQRenderState {
+  CDrawList drawList;
+  long      tick     { 0 };
+  int       inputSeq    { 0 };   // sequence of last input consumed by tick
+  double    consumeTime { 0.0 }; // time (secs) of first tick which consumed inputSeq
+};
+
+// Runs CSpaceInvaders::update at a fixed rate on its own thread.
+//
+// Input and commands arrive through a lock-free queue and each tick publishes
+// a render snapshot through a lock-free triple buffer, so the simulation and
+// GUI threads never block each other.
+//
+// Fast forward runs several ticks per period and renders (and records to the
+// frame stream) only the last.
+class CQSimThread {
+ public:
+  using RenderBuffer = CTripleBuffer<CQRenderState>;
+
+ public:
+  CQSimThread(CSpaceInvaders *invaders, const QElapsedTimer &timer);
+ ~CQSimThread();
+
+  void start();
+  void stop();
+
+  // record each tick's draw list to stream (set while stopped)
+  void setFrameStream(CFrameStreamWriter *stream) { stream_ = stream; }
+
+  // record each tick's input and commands to replay (set while stopped)
+  void setReplay(CReplay *replay) { replay_ = replay; }
+
+  // play with bot instead of user input, restarting on game over (set while stopped)
+  void setPolicy(CInvadersPolicy *policy) { policy_ = policy; }
+
+  // ticks per period (fast forward), any thread
+  int speed() const { return speed_; }
+
+  void setSpeed(int speed) { speed_ = std::max(speed, 1); }
+
+  // GUI thread
+  void setInput(const CQInput::State &state);
+
+  void pause  ();
+  void restart();
+
+  RenderBuffer &renderBuffer() { return renderBuffer_; }
+
+ private:
+  struct Command {
+    enum class Type {
+      INPUT,
+      PAUSE,
+      RESTART
+    };
+
+    Type           type { Type::INPUT };
+    CQInput::State input;
+  };
+
+  using CommandQueue = CSPSCQueue<Command,256>;
+
+  void sendCommand(const Command &command);
+
+  void run();
+
+  void tick();
+
+  void advance(uint8_t replayFlags);
+
+  void render();
+
+ private:
+  CSpaceInvaders*     invaders_    { nullptr };
+  QElapsedTimer       timer_;
+  CommandQueue        commands_;
+  RenderBuffer        renderBuffer_;
+  CFrameStreamWriter* stream_      { nullptr };
+  CReplay*            replay_      { nullptr };
+  CInvadersPolicy*    policy_      { nullptr };
+  std::thread         thread_;
+  std::atomic<bool>   stop_        { false };
+  std::atomic<int>    speed_       { 1 };
+  long                tick_        { 0 };
+  int                 consumeSeq_  { 0 };
+  double              consumeTime_ { 0.0 };
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include <CQSound.h>
 #include <QSound>
 #include <QAudioDeviceInfo>
+#include <CQStartup.h>
 #include <CSDLSound.h>
 
 CQSoundMgr *
@@ -25,16 +26,77 @@ setActive(bool active)
 CQSoundMgr::
 CQSoundMgr() :
  active_(true), qsound_(false), sdl_sound_(0)
+{
+}
+
+void
+CQSoundMgr::
+startInit()
+{
+  if (initStarted_) return;
+
+  initStarted_ = true;
+
+  CQStartup::mark("audio init started");
+
+  initThread_ = std::thread([this]() { init(); });
+}
+
+void
+CQSoundMgr::
+init()
 {
   //qsound_ = QSound::isAvailable();
   qsound_ = ! QAudioDeviceInfo::availableDevices(QAudio::AudioOutput).isEmpty();
+
+  CQStartup::mark("audio devices probed");
+
+  // SDL_Init and Mix_OpenAudio
+  if (! qsound_)
+    (void) CSDLSoundMgrInst;
+
+  CQStartup::mark("audio ready");
+
+  initFinished_ = true;
+}
+
+void
+CQSoundMgr::
+waitInit()
+{
+  if (initDone_) return;
+
+  startInit();
+
+  if (initThread_.joinable())
+    initThread_.join();
+
+  initDone_ = true;
+}
+
+bool
+CQSoundMgr::
+initDone()
+{
+  if (initDone_) return true;
+
+  // starting here keeps a later start from racing other SDL users
+  startInit();
+
+  if (! initFinished_) return false;
+
+  waitInit();
+
+  return true;
 }
 
 CQSound *
 CQSoundMgr::
 addSound(const char *filename)
 {
-  CQSound *sound = new CQSound(filename, qsound_);
+  startInit();
+
+  CQSound *sound = new CQSound(filename);
 
   sounds_.push_back(sound);
 
@@ -47,6 +109,13 @@ playSound(CQSound *sound)
 {
   if (! active_) return;
 
+  waitInit();
+
+  bool first = ! sound->isLoaded();
+
+  if (first)
+    sound->load(qsound_);
+
   SoundList::const_iterator p1, p2;
 
   if (qsound_) {
@@ -55,18 +124,29 @@ playSound(CQSound *sound)
   }
 
   sound->play();
+
+  if (first)
+    CQStartup::mark("first sound played");
+}
+
+void
+CQSoundMgr::
+clear()
+{
+  waitInit();
+
+  for (auto &sound : sounds_)
+    delete sound;
+
+  sounds_.clear();
 }
 
 //--------------
 
 CQSound::
-CQSound(const char *filename, bool qsound) :
- filename_(filename), qsound_(0)
+CQSound(const char *filename) :
+ filename_(filename), qsound_(0), sound_(0)
 {
-  if (qsound)
-    qsound_ = new QSound(filename);
-  else
-    sound_ = CSDLSoundMgrInst->createSound(filename);
 }
 
 CQSound::
@@ -76,13 +156,27 @@ CQSound::
   delete sound_;
 }
 
+void
+CQSound::
+load(bool qsound)
+{
+  if (loaded_) return;
+
+  if (qsound)
+    qsound_ = new QSound(filename_.c_str());
+  else
+    sound_ = CSDLSoundMgrInst->createSound(filename_.c_str());
+
+  loaded_ = true;
+}
+
 void
 CQSound::
 play()
 {
   if (qsound_)
     qsound_->play();
-  else
+  else if (sound_)
     sound_->play();
 }
 
@@ -92,6 +186,6 @@ stop()
 {
   if (qsound_)
     qsound_->stop();
-  else
+  else if (sound_)
     sound_->stop();
 }
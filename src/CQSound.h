@@ -1,8 +1,10 @@
 #ifndef CQSound_H
 #define CQSound_H
 
+#include <atomic>
 #include <list>
 #include <string>
+#include <thread>
 
 #define CQSoundMgrInst CQSoundMgr::getInstance()
 
@@ -10,37 +12,68 @@ class QSound;
 class CQSound;
 class CSDLSound;
 
+// Audio device probing and bring-up (QAudioDeviceInfo, or SDL_Init and
+// Mix_OpenAudio when Qt has no output device) are slow, so they run on a
+// background thread (startInit) while the window is shown. Sounds are only
+// named when added and their backend sound is created on first play, which
+// waits for the init thread to finish.
+//
+// SDL init is not thread safe, so nothing else may initialize SDL (e.g. game
+// controllers) until initDone() returns true.
 class CQSoundMgr {
  public:
   static CQSoundMgr *getInstance();
 
   void setActive(bool active);
 
+  // start background audio init (called on first addSound if not before)
+  void startInit();
+
+  // wait for init thread (before exit if init was started)
+  void waitInit();
+
+  // true once init has finished (starts init if needed, does not block)
+  bool initDone();
+
   CQSound *addSound(const char *filename);
 
   void playSound(CQSound *sound);
 
+  void clear();
+
  private:
   CQSoundMgr();
  ~CQSoundMgr() { }
 
+  // probe devices and open audio (init thread)
+  void init();
+
  private:
   typedef std::list<CQSound *> SoundList;
 
-  bool       active_;
-  bool       qsound_;
-  CSDLSound *sdl_sound_;
-  SoundList  sounds_;
+  bool        active_;
+  bool        qsound_;
+  CSDLSound  *sdl_sound_;
+  SoundList   sounds_;
+  std::thread       initThread_;
+  bool              initStarted_  { false };
+  bool              initDone_     { false };
+  std::atomic<bool> initFinished_ { false };
 };
 
 class CQSound {
  public:
-  CQSound(const char *filename, bool qsound);
+  CQSound(const char *filename);
 
  ~CQSound();
 
   const std::string &getFilename() const { return filename_; }
 
+  bool isLoaded() const { return loaded_; }
+
+  // create backend sound (audio must be initialized)
+  void load(bool qsound);
+
   void play();
 
   void stop();
@@ -49,6 +82,7 @@ class CQSound {
   std::string  filename_;
   QSound      *qsound_;
   CSDLSound   *sound_;
+  bool         loaded_ { false };
 };
 
 #endif
@@ -2,80 +2,393 @@
 #include <QPainter>
 #include <QTimer>
 #include <QKeyEvent>
+#include <QFocusEvent>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
 #include <CQSpaceInvaders.h>
+#include <CQApp.h>
+#include <CQInput.h>
+#include <CQLatency.h>
+#include <CQSimThread.h>
+#include <CQStartup.h>
 #include <CQSound.h>
+#include <CFrameStream.h>
+#include <CReplay.h>
+#include <chrono>
+#include <thread>
 
-struct Image {
-  QImage image;
+App::ImageList  App::images_;
+App::SoundList  App::sounds_;
+CDrawList      *App::drawList_ = nullptr;
+App::SoundQueue App::soundQueue_;
 
-  Image(QImage image1) :
-   image(image1) {
-  }
-};
+#include <CSpaceInvaders.h>
+#include <CSearchPolicy.h>
 
-struct Sound {
-  CQSound *sound;
+int
+main(int argc, char **argv)
+{
+  CQStartup::start();
+
+  QApplication app(argc, argv);
 
-  Sound(CQSound *sound1) :
-   sound(sound1) {
+  CQStartup::mark("application created");
+
+  // probe and open audio device while the window is created
+  CQSoundMgrInst->startInit();
+
+  bool        startup = false;
+  bool        latency = false;
+  bool        memory  = false;
+  bool        bot     = false;
+  int         speed   = 1;
+  std::string levelsFile;
+  std::string recordFile;
+  std::string replayFile;
+  std::string viewFile;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-levels") == 0 && i < argc - 1)
+      levelsFile = argv[++i];
+    else if (strcmp(argv[i], "-latency") == 0)
+      latency = true;
+    else if (strcmp(argv[i], "-memory") == 0)
+      memory = true;
+    else if (strcmp(argv[i], "-startup") == 0)
+      startup = true;
+    else if (strcmp(argv[i], "-record") == 0 && i < argc - 1)
+      recordFile = argv[++i];
+    else if (strcmp(argv[i], "-view") == 0 && i < argc - 1)
+      viewFile = argv[++i];
+    else if (strcmp(argv[i], "-replay") == 0 && i < argc - 1)
+      replayFile = argv[++i];
+    else if (strcmp(argv[i], "-bot") == 0)
+      bot = true;
+    else if (strcmp(argv[i], "-speed") == 0 && i < argc - 1)
+      speed = atoi(argv[++i]);
+    else
+      std::cerr << "Invalid option '" << argv[i] << "'" << std::endl;
   }
-};
 
-class App {
- public:
-  static Image *loadImage(const char *filename);
+  // audio init thread must finish before exit
+  auto fail = []() { CQSoundMgrInst->waitInit(); return 1; };
 
-  static Sound *loadSound(const char *filename);
+  // levels.txt in current dir is optional, explicit levels file is not
+  CLevels levels;
 
-  static void drawImage(int x, int y, Image *image);
+  if      (levelsFile != "") {
+    if (! levels.load(levelsFile))
+      return fail();
+  }
+  else if (access("levels.txt", R_OK) == 0)
+    levels.load("levels.txt");
 
-  static void drawLeftText    (int x, int y, const char *str);
-  static void drawCenteredText(int x, int y, const char *str);
-  static void drawRightText   (int x, int y, const char *str);
+  CQStartup::mark("levels loaded");
 
-  static void playSound(Sound *sound);
+  CQSpaceInvaders *invaders = new CQSpaceInvaders(&levels);
 
-  static QPainter *painter;
+  CQStartup::mark("game created");
 
- private:
-  typedef std::map<std::string,Image *> ImageList;
-  typedef std::map<std::string,Sound *> SoundList;
+  invaders->setMeasureLatency(latency);
 
-  static ImageList images_;
-  static SoundList sounds_;
-};
+  if (memory)
+    invaders->reportMemory();
 
-App::ImageList App::images_;
-App::SoundList App::sounds_;
+  if (recordFile != "" && ! invaders->recordStream(recordFile))
+    return fail();
 
-#include <CSpaceInvaders.h>
+  if (viewFile != "" && ! invaders->viewStream(viewFile))
+    return fail();
 
-int
-main(int argc, char **argv)
-{
-  QApplication app(argc, argv);
+  if (replayFile != "")
+    invaders->recordReplay(replayFile);
+
+  if (bot)
+    invaders->setBot(true);
 
-  CQSpaceInvaders *invaders = new CQSpaceInvaders;
+  invaders->setSpeed(speed);
 
   invaders->resize(800, 1000);
 
   invaders->show();
 
-  return app.exec();
+  CQStartup::mark("window shown");
+
+  int rc = app.exec();
+
+  if (startup)
+    CQStartup::report(std::cerr);
+
+  invaders->reportLatency();
+
+  invaders->reportStream();
+
+  invaders->saveReplay();
+
+  invaders->reportBot();
+
+  delete invaders;
+
+  App::term();
+
+  return rc;
 }
 
 CQSpaceInvaders::
-CQSpaceInvaders()
+CQSpaceInvaders(const CLevels *levels)
 {
   setFont(QFont("Helvetica", 20));
 
-  invaders_ = new CSpaceInvaders;
+  invaders_ = new CSpaceInvaders(levels);
+
+  input_ = new CQInput;
+
+  sim_ = new CQSimThread(invaders_, input_->timer());
 
-  QTimer *timer = new QTimer;
+  sim_->start();
+
+  // poll for new frames, sounds and gamepad faster than the simulation rate
+  QTimer *timer = new QTimer(this);
 
   connect(timer, SIGNAL(timeout()), this, SLOT(timerSlot()));
 
-  timer->start(1000.0/60.0);
+  timer->start(4);
+}
+
+CQSpaceInvaders::
+~CQSpaceInvaders()
+{
+  delete sim_;
+  delete bot_;
+  delete recorder_;
+  delete viewer_;
+  delete replay_;
+  delete latency_;
+  delete input_;
+  delete invaders_;
+}
+
+void
+CQSpaceInvaders::
+setMeasureLatency(bool b)
+{
+  delete latency_;
+
+  latency_ = (b ? new CQLatency : nullptr);
+}
+
+void
+CQSpaceInvaders::
+reportMemory()
+{
+  std::cerr << "Game memory: " << invaders_->memoryUsage() << " bytes (arena " <<
+               invaders_->arena().used() << "/" << invaders_->arena().size() << " bytes in " <<
+               invaders_->arena().numBlocks() << " blocks)" << std::endl;
+}
+
+void
+CQSpaceInvaders::
+reportLatency()
+{
+  if (latency_)
+    latency_->report(std::cerr);
+}
+
+bool
+CQSpaceInvaders::
+recordStream(const std::string &filename)
+{
+  CFrameStreamWriter *recorder =
+    new CFrameStreamWriter([](const Image *image) { return image->name; });
+
+  if (! recorder->open(filename)) {
+    delete recorder;
+    return false;
+  }
+
+  sim_->stop();
+
+  delete recorder_;
+
+  recorder_ = recorder;
+
+  sim_->setFrameStream(recorder_);
+
+  sim_->start();
+
+  return true;
+}
+
+bool
+CQSpaceInvaders::
+viewStream(const std::string &filename)
+{
+  CFrameStreamReader *viewer =
+    new CFrameStreamReader([](const std::string &name) { return App::loadImage(name.c_str()); });
+
+  if (! viewer->open(filename)) {
+    delete viewer;
+    return false;
+  }
+
+  // game is not run while viewing
+  sim_->stop();
+
+  delete viewer_;
+
+  viewer_ = viewer;
+
+  viewTick_ = 0;
+
+  return true;
+}
+
+void
+CQSpaceInvaders::
+reportStream()
+{
+  if (! recorder_) return;
+
+  sim_->stop();
+
+  recorder_->close();
+
+  long frames = recorder_->numFrames();
+
+  std::cerr << "Frame stream: " << frames << " frames, " << recorder_->bytesWritten() <<
+               " bytes (" << (frames ? recorder_->bytesWritten()/frames : 0) <<
+               " bytes/frame)" << std::endl;
+}
+
+void
+CQSpaceInvaders::
+recordReplay(const std::string &filename)
+{
+  sim_->stop();
+
+  delete replay_;
+
+  uint64_t seed = uint64_t(std::chrono::system_clock::now().time_since_epoch().count());
+
+  replay_     = new CReplay(seed);
+  replayFile_ = filename;
+
+  // start from a known state so the replay reproduces the session
+  invaders_->reset(seed);
+
+  sim_->setReplay(replay_);
+
+  sim_->start();
+}
+
+bool
+CQSpaceInvaders::
+saveReplay()
+{
+  if (! replay_) return true;
+
+  sim_->stop();
+
+  return replay_->save(replayFile_);
+}
+
+void
+CQSpaceInvaders::
+setBot(bool b)
+{
+  sim_->stop();
+
+  delete bot_;
+
+  bot_ = nullptr;
+
+  if (b) {
+    // leave a core for the GUI and half the tick for the rest of the simulation
+    CSearchPolicy::Params params;
+
+    params.numThreads = std::max(int(std::thread::hardware_concurrency()) - 1, 1);
+    params.budget     = 0.008;
+
+    bot_ = new CSearchPolicy(invaders_->levels(), params);
+  }
+
+  sim_->setPolicy(bot_);
+
+  sim_->start();
+}
+
+void
+CQSpaceInvaders::
+reportBot()
+{
+  if (! bot_) return;
+
+  sim_->stop();
+
+  std::cerr << "Bot: " << bot_->numRollouts() << " rollouts, " <<
+               bot_->rolloutsPerSec() << " rollouts/s" << std::endl;
+}
+
+void
+CQSpaceInvaders::
+setSpeed(int speed)
+{
+  // nearest supported speed
+  int s = 1;
+
+  while (s < 8 && 2*s <= speed)
+    s *= 2;
+
+  sim_->setSpeed(s);
+}
+
+void
+CQSpaceInvaders::
+updateView()
+{
+  double now = input_->elapsed();
+
+  bool changed = false;
+
+  long frameTick;
+
+  // first frame sets time base (frames were recorded at 60Hz)
+  if (viewTick_ == 0) {
+    if (! viewer_->readFrame(frameTick, viewDrawList_))
+      return;
+
+    viewTick_  = frameTick;
+    viewStart_ = now - frameTick/60.0;
+    changed    = true;
+  }
+
+  long tick = long((now - viewStart_)*60);
+
+  // skip to latest due frame
+  while (viewTick_ < tick && viewer_->readFrame(frameTick, viewDrawList_)) {
+    viewTick_ = frameTick;
+    changed   = true;
+  }
+
+  if (changed)
+    update();
+}
+
+bool
+CQSpaceInvaders::
+event(QEvent *e)
+{
+  // update request paints and flushes the backing store synchronously
+  if (latency_ && e->type() == QEvent::UpdateRequest) {
+    bool rc = QWidget::event(e);
+
+    latency_->frameFlushed(input_->elapsed());
+
+    return rc;
+  }
+
+  return QWidget::event(e);
 }
 
 void
@@ -90,46 +403,128 @@ void
 CQSpaceInvaders::
 paintEvent(QPaintEvent *)
 {
-  QPainter p(this);
+  if (viewer_) {
+    QPainter p(this);
+
+    p.fillRect(rect(), QBrush(QColor(0,0,0)));
+
+    CDrawListPainter::paint(&p, viewDrawList_);
+
+    return;
+  }
+
+  CQSimThread::RenderBuffer &buffer = sim_->renderBuffer();
 
-  App::painter = &p;
+  buffer.update();
+
+  const CQRenderState &state = buffer.front();
+
+  if (latency_) {
+    latency_->tickConsumed(state.inputSeq, state.consumeTime);
+    latency_->framePainted(state.inputSeq, input_->elapsed());
+  }
+
+  QPainter p(this);
 
   p.fillRect(rect(), QBrush(QColor(0,0,0)));
 
-  invaders_->draw();
+  CDrawListPainter::paint(&p, state.drawList);
+
+  if (! painted_) {
+    CQStartup::mark("first frame painted");
 
-  App::painter = NULL;
+    painted_ = true;
+  }
 }
 
 void
 CQSpaceInvaders::
 keyPressEvent(QKeyEvent *e)
 {
-  if      (e->key() == Qt::Key_Left)
-    invaders_->moveShipLeft();
-  else if (e->key() == Qt::Key_Right)
-    invaders_->moveShipRight();
-  else if (e->key() == Qt::Key_Space)
-    invaders_->shipFire();
-  else if (e->key() == Qt::Key_P)
-    invaders_->pause();
+  if (input_->keyPress(e)) {
+    if (latency_)
+      latency_->inputArrived(input_->keys().seq, input_->keys().time);
+
+    sendInput();
+
+    return;
+  }
+
+  if      (e->key() == Qt::Key_P)
+    sim_->pause();
   else if (e->key() == Qt::Key_R)
-    invaders_->restart();
+    sim_->restart();
+  else if (e->key() == Qt::Key_F)
+    setSpeed(sim_->speed() < 8 ? 2*sim_->speed() : 1);
+}
+
+void
+CQSpaceInvaders::
+keyReleaseEvent(QKeyEvent *e)
+{
+  if (input_->keyRelease(e)) {
+    if (latency_)
+      latency_->inputArrived(input_->keys().seq, input_->keys().time);
+
+    sendInput();
+  }
+}
+
+void
+CQSpaceInvaders::
+focusOutEvent(QFocusEvent *)
+{
+  // key releases go to the new focus window, so drop held keys now
+  if (input_->releaseKeys()) {
+    if (latency_)
+      latency_->inputArrived(input_->keys().seq, input_->keys().time);
+
+    sendInput();
+  }
+}
+
+void
+CQSpaceInvaders::
+sendInput()
+{
+  CQInput::State state = input_->sample();
+
+  if (state.seq == inputSeq_) return;
+
+  inputSeq_ = state.seq;
+
+  // gamepad changes arrive on sample
+  if (latency_)
+    latency_->inputArrived(state.seq, state.time);
+
+  sim_->setInput(state);
 }
 
 void
 CQSpaceInvaders::
 timerSlot()
 {
-  invaders_->update();
+  if (viewer_) {
+    updateView();
+    return;
+  }
+
+  // SDL is not thread safe so wait for audio init before opening controllers
+  if (! input_->isControllerInit() && CQSoundMgrInst->initDone())
+    input_->initController();
+
+  input_->poll();
 
-  update();
+  sendInput();
+
+  App::playSounds();
+
+  if (sim_->renderBuffer().hasNew())
+    update();
 }
 
 //------
 
-QPainter *App::painter = NULL;
-
 Image *
 App::
 loadImage(const char *filename)
@@ -143,7 +538,7 @@ loadImage(const char *filename)
 
   qimage.load(filename);
 
-  Image *image = new Image(qimage);
+  Image *image = new Image(qimage, filename);
 
   images_[filename] = image;
 
@@ -170,51 +565,68 @@ loadSound(const char *filename)
 
 void
 App::
-drawImage(int x, int y, Image *image)
+term()
 {
-  painter->drawImage(x, y, image->image);
+  for (auto &pi : images_)
+    delete pi.second;
+
+  for (auto &ps : sounds_)
+    delete ps.second;
+
+  images_.clear();
+  sounds_.clear();
+
+  CQSoundMgrInst->clear();
 }
 
 void
 App::
-drawLeftText(int x, int y, const char *str)
+drawImage(int x, int y, Image *image)
 {
-  QFontMetrics fm(painter->font());
+  drawList_->addImage(x, y, image);
+}
 
-  painter->setPen(QColor(255,255,255));
+void
+App::
+fillRect(int x, int y, int w, int h, uint32_t color)
+{
+  drawList_->addRect(x, y, w, h, color);
+}
 
-  painter->drawText(x, y + fm.ascent(), str);
+void
+App::
+drawLeftText(int x, int y, const char *str)
+{
+  drawList_->addText(CDrawList::Type::LEFT_TEXT, x, y, str);
 }
 
 void
 App::
 drawCenteredText(int x, int y, const char *str)
 {
-  QFontMetrics fm(painter->font());
-
-  int w = fm.width(str);
-
-  painter->setPen(QColor(255,255,255));
-
-  painter->drawText(x - w/2, y + fm.ascent(), str);
+  drawList_->addText(CDrawList::Type::CENTERED_TEXT, x, y, str);
 }
 
 void
 App::
 drawRightText(int x, int y, const char *str)
 {
-  QFontMetrics fm(painter->font());
-
-  int w = fm.width(str);
-
-  painter->setPen(QColor(255,255,255));
-
-  painter->drawText(x - w, y + fm.ascent(), str);
+  drawList_->addText(CDrawList::Type::RIGHT_TEXT, x, y, str);
 }
 
 void
 App::
 playSound(Sound *sound)
 {
-  CQSoundMgrInst->playSound(sound->sound);
+  (void) soundQueue_.push(sound);
+}
+
+void
+App::
+playSounds()
+{
+  Sound *sound;
+
+  while (soundQueue_.pop(sound))
+    CQSoundMgrInst->playSound(sound->sound);
 }
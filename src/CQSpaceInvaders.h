@@ -1,24 +1,86 @@
 #include <QWidget>
+#include <CDrawList.h>
+#include <string>
 
 class CSpaceInvaders;
+class CLevels;
+class CQInput;
+class CQLatency;
+class CQSimThread;
+class CFrameStreamWriter;
+class CFrameStreamReader;
+class CReplay;
+class CSearchPolicy;
 
 class CQSpaceInvaders : public QWidget {
   Q_OBJECT
 
  public:
-  CQSpaceInvaders();
+  CQSpaceInvaders(const CLevels *levels=nullptr);
+ ~CQSpaceInvaders();
+
+  void setMeasureLatency(bool b);
+
+  void reportMemory();
+
+  void reportLatency();
+
+  // record draw list of every tick to frame stream file
+  bool recordStream(const std::string &filename);
+
+  // play back frame stream file instead of running the game
+  bool viewStream(const std::string &filename);
+
+  void reportStream();
+
+  // record seed and per tick input of session (saved by saveReplay)
+  void recordReplay(const std::string &filename);
+
+  bool saveReplay();
+
+  // play with lookahead search bot (attract mode)
+  void setBot(bool b);
+
+  void reportBot();
+
+  // fast forward: ticks run per display tick (1, 2, 4 or 8)
+  void setSpeed(int speed);
+
+  bool event(QEvent *e);
 
   void resizeEvent(QResizeEvent *);
 
   void paintEvent(QPaintEvent *);
 
-  void keyPressEvent(QKeyEvent *e);
+  void keyPressEvent  (QKeyEvent *e);
+  void keyReleaseEvent(QKeyEvent *e);
+
+  void focusOutEvent(QFocusEvent *e);
 
  public slots:
   void timerSlot();
 
  private:
-  CSpaceInvaders* invaders_ { nullptr };
-  int             w_        { -1 };
-  int             h_        { -1 };
+  void sendInput();
+
+ private:
+  void updateView();
+
+ private:
+  CSpaceInvaders*     invaders_  { nullptr };
+  CQInput*            input_     { nullptr };
+  CQLatency*          latency_   { nullptr };
+  CQSimThread*        sim_       { nullptr };
+  CFrameStreamWriter* recorder_  { nullptr };
+  CFrameStreamReader* viewer_    { nullptr };
+  CReplay*            replay_    { nullptr };
+  CSearchPolicy*      bot_       { nullptr };
+  std::string         replayFile_;
+  CDrawList           viewDrawList_;
+  long                viewTick_  { 0 };
+  double              viewStart_ { 0.0 };
+  int                 inputSeq_  { 0 };
+  int                 w_         { -1 };
+  int                 h_         { -1 };
+  bool                painted_   { false };
 };
@@ -0,0 +1,105 @@
+#include <CQStartup.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Event {
+  const char *name { nullptr };
+  double      ms   { 0.0 };
+  bool        main { true }; // marked on start thread
+};
+
+struct Timeline {
+  std::mutex         mutex;
+  bool               started { false };
+  Clock::time_point  start;
+  std::thread::id    mainThread;
+  std::vector<Event> events;
+};
+
+Timeline &timeline() {
+  static Timeline timeline;
+
+  return timeline;
+}
+
+}
+
+void
+CQStartup::
+start()
+{
+  Timeline &t = timeline();
+
+  std::lock_guard<std::mutex> lock(t.mutex);
+
+  if (t.started) return;
+
+  t.started    = true;
+  t.start      = Clock::now();
+  t.mainThread = std::this_thread::get_id();
+}
+
+void
+CQStartup::
+mark(const char *event)
+{
+  start();
+
+  Timeline &t = timeline();
+
+  std::lock_guard<std::mutex> lock(t.mutex);
+
+  for (const auto &e : t.events) {
+    if (strcmp(e.name, event) == 0)
+      return;
+  }
+
+  Event e;
+
+  e.name = event;
+  e.ms   = std::chrono::duration<double, std::milli>(Clock::now() - t.start).count();
+  e.main = (std::this_thread::get_id() == t.mainThread);
+
+  t.events.push_back(e);
+}
+
+double
+CQStartup::
+time(const char *event)
+{
+  Timeline &t = timeline();
+
+  std::lock_guard<std::mutex> lock(t.mutex);
+
+  for (const auto &e : t.events) {
+    if (strcmp(e.name, event) == 0)
+      return e.ms;
+  }
+
+  return -1.0;
+}
+
+void
+CQStartup::
+report(std::ostream &os)
+{
+  Timeline &t = timeline();
+
+  std::lock_guard<std::mutex> lock(t.mutex);
+
+  os << "Startup timeline (ms, * = background thread):" << std::endl;
+
+  for (const auto &e : t.events)
+    os << std::setw(10) << std::fixed << std::setprecision(1) << e.ms <<
+          (e.main ? "  " : " *") << e.name << std::endl;
+}
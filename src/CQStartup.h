@@ -0,0 +1,24 @@
+#ifndef CQStartup_H
+#define CQStartup_H
+
+#include <iosfwd>
+
+// Startup timeline.
+//
+// Startup steps (on any thread) are marked with the time since the timeline
+// started (the start of main), so time to first frame and to audio ready can
+// be tracked. Each event is recorded once (repeats are ignored).
+class CQStartup {
+ public:
+  // start timeline (first mark if not called)
+  static void start();
+
+  static void mark(const char *event);
+
+  // time of event in ms (-1 if not marked)
+  static double time(const char *event);
+
+  static void report(std::ostream &os);
+};
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef CReplay_H
+#define CReplay_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Recorded game session: random seed and one input byte per tick.
+//
+// Replaying calls CSpaceInvaders::reset(seed) then, for each tick, applies the
+// recorded commands and held input and calls update, which reproduces the
+// session exactly (the game is deterministic for a given seed and input).
+//
+// The recorder's state hash (low 32 bits of CSpaceInvaders::stateHash) after
+// each tick is stored too so a playback can check it reproduces the session
+// and report the first tick where it does not (checkHash).
+//
+// File: "CQRP" magic, uint32 version, uint64 seed, uint32 numTicks, input bytes,
+// uint32 numHashes, uint32 hashes (version 1 files have no hashes).
+class CReplay {
+ public:
+  enum { VERSION = 2 };
+
+  enum TickFlags : uint8_t {
+    LEFT    = (1<<0),
+    RIGHT   = (1<<1),
+    FIRE    = (1<<2),
+    PAUSE   = (1<<3), // toggle pause before tick
+    RESTART = (1<<4)  // restart (if paused or game over) before tick
+  };
+
+  using Ticks  = std::vector<uint8_t>;
+  using Hashes = std::vector<uint32_t>;
+
+ public:
+  CReplay(uint64_t seed=1) :
+   seed_(seed) {
+  }
+
+  uint64_t seed() const { return seed_; }
+
+  void setSeed(uint64_t seed) { seed_ = seed; }
+
+  int numTicks() const { return int(ticks_.size()); }
+
+  uint8_t tick(int i) const { return ticks_[i]; }
+
+  const Ticks &ticks() const { return ticks_; }
+
+  void clear() { ticks_.clear(); hashes_.clear(); }
+
+  void addTick(uint8_t flags) { ticks_.push_back(flags); }
+
+  //---
+
+  int numHashes() const { return int(hashes_.size()); }
+
+  // state hash after tick i is recorded
+  bool hasHash(int i) const { return i >= 0 && i < int(hashes_.size()); }
+
+  uint32_t hash(int i) const { return hashes_[i]; }
+
+  // record state hash after the last added tick
+  void addHash(uint64_t hash) { hashes_.push_back(uint32_t(hash)); }
+
+  // state hash after tick i matches recording (true if not recorded)
+  bool checkHash(int i, uint64_t hash) const {
+    return (! hasHash(i) || hashes_[i] == uint32_t(hash));
+  }
+
+  template<typename GAME>
+  static void applyTick(GAME &game, uint8_t flags) {
+    if (flags & PAUSE  ) game.pause();
+    if (flags & RESTART) game.restart();
+
+    auto input = game.input();
+
+    input.left  = (flags & LEFT );
+    input.right = (flags & RIGHT);
+    input.fire  = (flags & FIRE );
+
+    game.setInput(input);
+
+    game.update();
+  }
+
+  bool save(const std::string &filename) const {
+    FILE *fp = fopen(filename.c_str(), "wb");
+
+    if (! fp) {
+      std::cerr << "Error: Failed to write replay '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    uint32_t version   = VERSION;
+    uint32_t numTicks  = uint32_t(ticks_.size());
+    uint32_t numHashes = uint32_t(hashes_.size());
+
+    bool ok = (fwrite("CQRP"     , 4, 1, fp) == 1 &&
+               fwrite(&version   , sizeof(version ), 1, fp) == 1 &&
+               fwrite(&seed_     , sizeof(seed_   ), 1, fp) == 1 &&
+               fwrite(&numTicks  , sizeof(numTicks), 1, fp) == 1 &&
+               (numTicks == 0 || fwrite(&ticks_[0], 1, numTicks, fp) == numTicks) &&
+               fwrite(&numHashes , sizeof(numHashes), 1, fp) == 1 &&
+               (numHashes == 0 ||
+                fwrite(&hashes_[0], sizeof(uint32_t), numHashes, fp) == numHashes));
+
+    fclose(fp);
+
+    if (! ok)
+      std::cerr << "Error: Failed to write replay '" << filename << "'" << std::endl;
+
+    return ok;
+  }
+
+  bool load(const std::string &filename) {
+    FILE *fp = fopen(filename.c_str(), "rb");
+
+    if (! fp) {
+      std::cerr << "Error: Failed to read replay '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    char     magic[4];
+    uint32_t version   = 0;
+    uint64_t seed      = 0;
+    uint32_t numTicks  = 0;
+    uint32_t numHashes = 0;
+
+    bool ok = (fread(magic    , 4, 1, fp) == 1 && memcmp(magic, "CQRP", 4) == 0 &&
+               fread(&version , sizeof(version ), 1, fp) == 1 &&
+               (version == 1 || version == VERSION) &&
+               fread(&seed    , sizeof(seed    ), 1, fp) == 1 &&
+               fread(&numTicks, sizeof(numTicks), 1, fp) == 1);
+
+    Ticks ticks(ok ? numTicks : 0);
+
+    if (ok && numTicks > 0)
+      ok = (fread(&ticks[0], 1, numTicks, fp) == numTicks);
+
+    if (ok && version >= 2)
+      ok = (fread(&numHashes, sizeof(numHashes), 1, fp) == 1 && numHashes <= numTicks);
+
+    Hashes hashes(ok ? numHashes : 0);
+
+    if (ok && numHashes > 0)
+      ok = (fread(&hashes[0], sizeof(uint32_t), numHashes, fp) == numHashes);
+
+    fclose(fp);
+
+    if (! ok) {
+      std::cerr << "Error: Invalid replay '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    seed_ = seed;
+
+    ticks_ .swap(ticks);
+    hashes_.swap(hashes);
+
+    return true;
+  }
+
+ private:
+  uint64_t seed_ { 1 };
+  Ticks    ticks_;
+  Hashes   hashes_;
+};
+
+#endif
@@ -0,0 +1,322 @@
+#ifndef CRollbackSession_H
+#define CRollbackSession_H
+
+#include <CVersusGame.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// One peer of a two player CVersusGame using prediction and rollback.
+//
+// The local player's input is scheduled inputDelay ticks ahead and sent to the
+// peer. Ticks whose remote input has not arrived are simulated with a
+// predicted input (the last remote input received). The state at the start of
+// each unconfirmed tick is saved, so when a remote input arrives which
+// differs from its prediction the game is restored to that tick and the ticks
+// since are re-simulated with the corrected inputs. The peer stalls rather
+// than predict more than maxRollback ticks ahead of its confirmed input.
+//
+// Packets carry every local input the peer has not acknowledged (so lost
+// packets need no resend), the sender's tick and its frame advantage over the
+// receiver. Peers compare advantages to keep their ticks in step: the peer
+// which is ahead waits half the difference (time sync).
+//
+// The checksum (state hash) after each tick is kept once the tick's inputs
+// are confirmed. Each packet carries the sender's latest confirmed checksum
+// and the receiver compares it with its own for that tick, recording the
+// first tick found to differ (desyncTick).
+//
+// Transport is up to the caller: makePacket and receivePacket just fill and
+// parse byte buffers.
+class CRollbackSession {
+ public:
+  enum { MAX_ROLLBACK   = 32 };
+  enum { MAX_DELAY      = 16 };
+  enum { MAX_INPUTS     = 128 }; // inputs per packet (covers 2*(MAX_ROLLBACK + MAX_DELAY))
+  enum { HISTORY        = 256 }; // ticks of input and checksums kept (power of 2)
+  enum { SYNC_INTERVAL  = 30 };  // ticks between time sync checks
+  enum { MAX_SYNC_WAIT  = 8 };
+
+  struct Params {
+    int maxRollback { 8 }; // ticks predicted ahead of confirmed remote input
+    int inputDelay  { 2 }; // ticks local input is scheduled ahead
+  };
+
+#pragma pack(push, 1)
+  struct PacketHeader {
+    uint8_t  magic;       // PACKET_MAGIC
+    uint8_t  player;      // sender
+    int8_t   advantage;   // sender ticks ahead of receiver (clamped)
+    uint8_t  numInputs;
+    uint32_t tick;        // sender's current tick
+    uint32_t ack;         // receiver inputs received up to (exclusive)
+    uint32_t startTick;   // tick of first input
+    uint32_t confirmed;   // sender ticks confirmed
+    uint32_t hash;        // low bits of sender checksum of tick confirmed - 1
+  };
+#pragma pack(pop)
+
+  enum { PACKET_MAGIC = 0xa7 };
+  enum { MAX_PACKET   = sizeof(PacketHeader) + MAX_INPUTS };
+
+ public:
+  CRollbackSession(int localPlayer, const CLevels *levels, const Params &params) :
+   params_(params), localPlayer_(localPlayer), remotePlayer_(1 - localPlayer), game_(levels) {
+    params_.maxRollback = std::min(std::max(params_.maxRollback, 1), int(MAX_ROLLBACK));
+    params_.inputDelay  = std::min(std::max(params_.inputDelay , 0), int(MAX_DELAY));
+
+    // state at start of each unconfirmed tick
+    for (int i = 0; i <= params_.maxRollback; ++i)
+      snapshots_.push_back(std::make_unique<CVersusGame>(levels));
+  }
+
+  CRollbackSession(const CRollbackSession &) = delete;
+  CRollbackSession &operator=(const CRollbackSession &) = delete;
+
+  const Params &params() const { return params_; }
+
+  int localPlayer() const { return localPlayer_; }
+
+  const CVersusGame &game() const { return game_; }
+
+  // next tick to simulate
+  long tick() const { return game_.tick(); }
+
+  // ticks whose inputs are all known and simulated (checksum is final)
+  long confirmedTick() const { return confirmed_; }
+
+  // checksum of state after confirmed tick t (within last HISTORY ticks)
+  uint64_t checksum(long t) const { return checksums_[t & (HISTORY - 1)]; }
+
+  // first tick whose checksum differs from the peer's (-1 if none found)
+  long desyncTick() const { return desyncTick_; }
+
+  // stats
+  long numRollbacks   () const { return numRollbacks_; }
+  long numResimTicks  () const { return numResimTicks_; }
+  int  maxRollbackTicks() const { return maxRollbackTicks_; }
+  long numStalls      () const { return numStalls_; }
+  long numSyncWaits   () const { return numSyncWaits_; }
+
+  void start(uint64_t seed) {
+    game_.reset(seed);
+
+    // ticks before the input delay have no input from either player
+    localInputs_  = params_.inputDelay;
+    remoteInputs_ = params_.inputDelay;
+    peerAck_       = 0;
+    peerTick_      = 0;
+    peerAdvantage_ = 0;
+    rollbackTick_  = -1;
+    lastRemote_    = 0;
+    confirmed_     = 0;
+    syncWait_      = 0;
+    desyncTick_    = -1;
+
+    for (int p = 0; p < CVersusGame::NUM_PLAYERS; ++p)
+      std::fill(inputs_[p], inputs_[p] + HISTORY, 0);
+
+    std::fill(used_, used_ + HISTORY, 0);
+  }
+
+  // Run one frame with the local player's current input. Applies any pending
+  // rollback then simulates the next tick, unless waiting for the peer
+  // (returns false).
+  bool advance(uint8_t localInput) {
+    applyRollback();
+
+    long t = tick();
+
+    // time sync: the peer ahead waits half the difference in advantage (the
+    // peer sees the effect a round trip later so only check periodically)
+    if (syncWait_ == 0 && t % SYNC_INTERVAL == 0 && peerTick_ > 0)
+      syncWait_ = std::min((frameAdvantage() - peerAdvantage_)/2, long(MAX_SYNC_WAIT));
+
+    if (syncWait_ > 0) {
+      --syncWait_;
+      ++numSyncWaits_;
+      return false;
+    }
+
+    // too far ahead of confirmed remote input
+    if (t - remoteInputs_ >= params_.maxRollback) {
+      ++numStalls_;
+      return false;
+    }
+
+    // schedule local input ahead
+    if (localInputs_ - t < MAX_INPUTS - 1) {
+      inputs_[localPlayer_][localInputs_ & (HISTORY - 1)] = localInput;
+
+      ++localInputs_;
+    }
+
+    simulate(t);
+
+    return true;
+  }
+
+  // fill packet to peer, returns size
+  size_t makePacket(char *data) const {
+    PacketHeader header;
+
+    long start = std::max(peerAck_, localInputs_ - long(MAX_INPUTS));
+
+    header.magic     = PACKET_MAGIC;
+    header.player    = uint8_t(localPlayer_);
+    header.advantage = int8_t(std::min(std::max(frameAdvantage(), -127L), 127L));
+    header.numInputs = uint8_t(localInputs_ - start);
+    header.tick      = uint32_t(tick());
+    header.ack       = uint32_t(remoteInputs_);
+    header.startTick = uint32_t(start);
+    header.confirmed = uint32_t(confirmed_);
+    header.hash      = uint32_t(confirmed_ > 0 ? checksum(confirmed_ - 1) : 0);
+
+    memcpy(data, &header, sizeof(header));
+
+    for (int i = 0; i < header.numInputs; ++i)
+      data[sizeof(header) + i] = char(inputs_[localPlayer_][(start + i) & (HISTORY - 1)]);
+
+    return sizeof(header) + header.numInputs;
+  }
+
+  // handle packet from peer (malformed or stale packets are ignored)
+  void receivePacket(const char *data, size_t size) {
+    PacketHeader header;
+
+    if (size < sizeof(header)) return;
+
+    memcpy(&header, data, sizeof(header));
+
+    if (header.magic != PACKET_MAGIC || header.player != remotePlayer_ ||
+        size != sizeof(header) + header.numInputs || long(header.startTick) > remoteInputs_)
+      return;
+
+    if (long(header.tick) >= peerTick_) {
+      peerTick_      = header.tick;
+      peerAdvantage_ = header.advantage;
+    }
+
+    peerAck_ = std::max(peerAck_, long(header.ack));
+
+    checkHash(header.confirmed, header.hash);
+
+    // accept inputs continuing the received sequence
+    long start = header.startTick;
+    long end   = start + header.numInputs;
+
+    for (long t = std::max(start, remoteInputs_); t < end; ++t) {
+      uint8_t input = uint8_t(data[sizeof(header) + (t - start)]);
+
+      inputs_[remotePlayer_][t & (HISTORY - 1)] = input;
+
+      lastRemote_ = input;
+
+      remoteInputs_ = t + 1;
+
+      if (t >= tick()) continue;
+
+      // simulated tick used a wrong prediction
+      if (used_[t & (HISTORY - 1)] != input) {
+        if (rollbackTick_ < 0)
+          rollbackTick_ = t;
+      }
+      // state after tick is now final unless an earlier tick is being rolled back
+      else if (rollbackTick_ < 0)
+        confirm(t, (t + 1 < tick() ? snapshot(t + 1) : game_));
+    }
+  }
+
+ private:
+  // local ticks ahead of peer (as of the peer's last packet)
+  long frameAdvantage() const { return tick() - peerTick_; }
+
+  CVersusGame &snapshot(long t) { return *snapshots_[t % snapshots_.size()]; }
+
+  // compare peer's checksum of tick confirmed - 1 with ours (if still kept)
+  void checkHash(long confirmed, uint32_t hash) {
+    long t = confirmed - 1;
+
+    if (t < 0 || t >= confirmed_ || confirmed_ - t > HISTORY) return;
+
+    if (uint32_t(checksum(t)) != hash && (desyncTick_ < 0 || t < desyncTick_))
+      desyncTick_ = t;
+  }
+
+  void simulate(long t) {
+    // save state at start of tick while it may still be rolled back
+    if (t >= remoteInputs_)
+      snapshot(t).copyState(game_);
+
+    uint8_t actions[CVersusGame::NUM_PLAYERS];
+
+    actions[localPlayer_ ] = inputs_[localPlayer_][t & (HISTORY - 1)];
+    actions[remotePlayer_] = (t < remoteInputs_ ?
+      inputs_[remotePlayer_][t & (HISTORY - 1)] : lastRemote_);
+
+    used_[t & (HISTORY - 1)] = actions[remotePlayer_];
+
+    game_.update(actions);
+
+    if (t < remoteInputs_)
+      confirm(t, game_);
+  }
+
+  void confirm(long t, const CVersusGame &game) {
+    checksums_[t & (HISTORY - 1)] = game.checksum();
+
+    confirmed_ = t + 1;
+  }
+
+  void applyRollback() {
+    if (rollbackTick_ < 0) return;
+
+    long t1 = rollbackTick_;
+    long t2 = tick();
+
+    rollbackTick_ = -1;
+
+    game_.copyState(snapshot(t1));
+
+    for (long t = t1; t < t2; ++t)
+      simulate(t);
+
+    ++numRollbacks_;
+
+    numResimTicks_ += t2 - t1;
+
+    maxRollbackTicks_ = std::max(maxRollbackTicks_, int(t2 - t1));
+  }
+
+ private:
+  using Snapshots = std::vector<std::unique_ptr<CVersusGame>>;
+
+  Params      params_;
+  int         localPlayer_      { 0 };
+  int         remotePlayer_     { 1 };
+  CVersusGame game_;
+  Snapshots   snapshots_;
+  uint8_t     inputs_[CVersusGame::NUM_PLAYERS][HISTORY] = {};
+  uint8_t     used_[HISTORY] = {};   // remote input used for each simulated tick
+  uint64_t    checksums_[HISTORY] = {};
+  long        confirmed_        { 0 }; // ticks with final checksum
+  long        syncWait_         { 0 }; // frames left to wait for time sync
+  long        desyncTick_       { -1 };
+  long        localInputs_      { 0 }; // local inputs known up to (exclusive)
+  long        remoteInputs_     { 0 }; // remote inputs received up to (exclusive)
+  long        peerAck_          { 0 }; // local inputs peer has received
+  long        peerTick_         { 0 };
+  long        peerAdvantage_    { 0 };
+  long        rollbackTick_     { -1 };
+  uint8_t     lastRemote_       { 0 };
+  long        numRollbacks_     { 0 };
+  long        numResimTicks_    { 0 };
+  int         maxRollbackTicks_ { 0 };
+  long        numStalls_        { 0 };
+  long        numSyncWaits_     { 0 };
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef CSPSCQueue_H
+#define CSPSCQueue_H
+
+#include <atomic>
+#include <cstddef>
+
+// Lock-free single producer/single consumer ring of N-1 items.
+template<typename T, size_t N>
+class CSPSCQueue {
+ public:
+  CSPSCQueue() { }
+
+  // producer (returns false if full)
+  bool push(const T &t) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t next = (head + 1) % N;
+
+    if (next == tail_.load(std::memory_order_acquire))
+      return false;
+
+    items_[head] = t;
+
+    head_.store(next, std::memory_order_release);
+
+    return true;
+  }
+
+  // consumer (returns false if empty)
+  bool pop(T &t) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+
+    if (tail == head_.load(std::memory_order_acquire))
+      return false;
+
+    t = items_[tail];
+
+    tail_.store((tail + 1) % N, std::memory_order_release);
+
+    return true;
+  }
+
+ private:
+  T                   items_[N];
+  std::atomic<size_t> head_ { 0 };
+  std::atomic<size_t> tail_ { 0 };
+};
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef CSearchPolicy_H
+#define CSearchPolicy_H
+
+#include <CInvadersPolicy.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// CSearchPolicy parameters
+struct CSearchParams {
+  int    numThreads  { 0 };     // 0 for all cores
+  double budget      { 0.008 }; // secs per decision (0 for no limit)
+  int    maxRollouts { 256 };   // per decision
+  int    horizon     { 120 };   // ticks per rollout
+  int    repeat      { 4 };     // ticks candidate action is held
+  double randomMove  { 0.1 };   // chance of random move in rollout
+};
+
+//---
+
+// Monte Carlo lookahead bot.
+//
+// Each decision copies the game state into per thread scratch games
+// (CSpaceInvaders::copyState, no allocation) and rolls each candidate action
+// out for a number of ticks: the candidate is held for the first few ticks then
+// the scripted bot plays, with occasional random moves held for a few ticks so
+// rollouts of the same candidate differ. The candidate with the best mean
+// rollout value (score gained plus a bonus per alien killed in the formation's
+// lowest row, less penalties for lives lost and game over) is chosen. The low
+// row bonus steers the bot to clear the aliens closest to landing, which the
+// scripted rollout bot (outer columns) does not target. Rollouts are spread
+// over a persistent set of threads and stop at a per decision time budget or
+// rollout limit.
+//
+// Scratch games share the real game's random number state so alien fire is
+// predicted exactly until player actions change the sequence.
+//
+// Include after CSpaceInvaders.h.
+class CSearchPolicy : public CInvadersPolicy {
+ public:
+  using Protocol = CInvadersProtocol;
+  using Clock    = std::chrono::steady_clock;
+
+  using Params = CSearchParams;
+
+ private:
+  enum { NUM_ACTIONS = 6 };
+
+  static constexpr uint8_t actions_[NUM_ACTIONS] = {
+    0, Protocol::ACTION_LEFT, Protocol::ACTION_RIGHT,
+    Protocol::ACTION_FIRE,
+    Protocol::ACTION_FIRE | Protocol::ACTION_LEFT,
+    Protocol::ACTION_FIRE | Protocol::ACTION_RIGHT
+  };
+
+  enum { LOW_ALIEN_BONUS   = 20 };
+  enum { LIFE_PENALTY      = 1000 };
+  enum { GAME_OVER_PENALTY = 10000 };
+
+ public:
+  // levels must match those of the games passed to act
+  CSearchPolicy(const CLevels *levels, const Params &params=Params()) :
+   params_(params) {
+    int numThreads = params_.numThreads;
+
+    if (numThreads <= 0)
+      numThreads = std::max(int(std::thread::hardware_concurrency()), 1);
+
+    for (int i = 0; i < numThreads; ++i) {
+      workers_.push_back(std::make_unique<Worker>(levels));
+
+      workers_.back()->game.setSoundEnabled  (false);
+      workers_.back()->game.setEffectsEnabled(false);
+    }
+
+    for (int i = 1; i < numThreads; ++i)
+      threads_.emplace_back([this, i]() { workerLoop(i); });
+  }
+
+ ~CSearchPolicy() {
+    {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    quit_ = true;
+    }
+
+    startCv_.notify_all();
+
+    for (auto &thread : threads_)
+      thread.join();
+  }
+
+  CSearchPolicy(const CSearchPolicy &) = delete;
+  CSearchPolicy &operator=(const CSearchPolicy &) = delete;
+
+  int numThreads() const { return int(workers_.size()); }
+
+  // total rollouts and time spent searching
+  long   numRollouts() const { return numRollouts_; }
+  double searchTime () const { return searchTime_; }
+
+  double rolloutsPerSec() const { return (searchTime_ > 0 ? numRollouts_/searchTime_ : 0.0); }
+
+  void reset(uint64_t seed) override {
+    seed_ = seed;
+  }
+
+  uint8_t act(const CSpaceInvaders &game) override {
+    if (game.isGameOver() || game.isPaused())
+      return 0;
+
+    auto t1 = Clock::now();
+
+    root_        = &game;
+    deadline_    = t1 + std::chrono::duration_cast<Clock::duration>(
+                          std::chrono::duration<double>(params_.budget));
+    nextRollout_ = 0;
+
+    ++decision_;
+
+    for (auto &worker : workers_)
+      worker->reset();
+
+    // wake workers and search on this thread too
+    {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    numBusy_ = numThreads() - 1;
+
+    ++generation_;
+    }
+
+    startCv_.notify_all();
+
+    runRollouts(0);
+
+    {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    doneCv_.wait(lock, [this]() { return numBusy_ == 0; });
+    }
+
+    root_ = nullptr;
+
+    // pick best mean value
+    double sum  [NUM_ACTIONS] = {};
+    int    count[NUM_ACTIONS] = {};
+
+    for (const auto &worker : workers_) {
+      for (int a = 0; a < NUM_ACTIONS; ++a) {
+        sum  [a] += worker->sum  [a];
+        count[a] += worker->count[a];
+
+        numRollouts_ += worker->count[a];
+      }
+    }
+
+    int    best      = NUM_ACTIONS - 3; // fire only
+    double bestValue = -1e300;
+
+    for (int a = 0; a < NUM_ACTIONS; ++a) {
+      if (count[a] == 0) continue;
+
+      double value = sum[a]/count[a];
+
+      if (value > bestValue) {
+        best      = a;
+        bestValue = value;
+      }
+    }
+
+    searchTime_ += std::chrono::duration<double>(Clock::now() - t1).count();
+
+    return actions_[best];
+  }
+
+ private:
+  struct Worker {
+    CSpaceInvaders game;
+    double         sum  [NUM_ACTIONS] = {};
+    int            count[NUM_ACTIONS] = {};
+
+    Worker(const CLevels *levels) :
+     game(levels) {
+    }
+
+    void reset() {
+      for (int a = 0; a < NUM_ACTIONS; ++a) {
+        sum  [a] = 0.0;
+        count[a] = 0;
+      }
+    }
+  };
+
+  void workerLoop(int i) {
+    long generation = 0;
+
+    for (;;) {
+      {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      startCv_.wait(lock, [&]() { return quit_ || generation_ != generation; });
+
+      if (quit_) return;
+
+      generation = generation_;
+      }
+
+      runRollouts(i);
+
+      {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      --numBusy_;
+      }
+
+      doneCv_.notify_one();
+    }
+  }
+
+  void runRollouts(int i) {
+    Worker &worker = *workers_[i];
+
+    for (;;) {
+      int n = nextRollout_++;
+
+      if (n >= params_.maxRollouts) break;
+
+      // every candidate gets at least one rollout
+      if (n >= NUM_ACTIONS && params_.budget > 0 && Clock::now() >= deadline_)
+        break;
+
+      int a = n % NUM_ACTIONS;
+
+      worker.sum  [a] += rollout(worker.game, actions_[a], n);
+      worker.count[a] += 1;
+    }
+  }
+
+  double rollout(CSpaceInvaders &game, uint8_t action, int n) {
+    game.copyState(*root_);
+
+    int startScore = game.getScore();
+    int startLives = game.getLives();
+    int startLevel = game.getLevel();
+
+    // live aliens in lowest row
+    const AlienFormation &aliens = game.getAliens();
+
+    int lowRow   = (aliens.numAlive() > 0 ? aliens.bottomRow() : -1);
+    int lowAlive = (lowRow >= 0 ? aliens.rowAlive(lowRow) : 0);
+
+    Random rng(seed_ ^ (uint64_t(decision_) << 20) ^ uint64_t(n));
+
+    uint8_t move = 0;
+
+    for (int t = 0; t < params_.horizon && ! game.isGameOver(); ++t) {
+      uint8_t a = action;
+
+      if (t >= params_.repeat) {
+        // scripted bot with random moves held for a few ticks
+        if ((t - params_.repeat) % 8 == 0)
+          move = (rng.random() < params_.randomMove ? actions_[3 + int(rng.random()*3)] : 0);
+
+        a = (move ? move : scripted_.act(game));
+      }
+
+      Input input;
+
+      input.left  = (a & Protocol::ACTION_LEFT );
+      input.right = (a & Protocol::ACTION_RIGHT);
+      input.fire  = (a & Protocol::ACTION_FIRE );
+
+      game.setInput(input);
+
+      game.update();
+    }
+
+    double value = game.getScore() - startScore;
+
+    // a new wave refills the grid (whole low row was cleared)
+    int lowKilled = (game.getLevel() != startLevel ? lowAlive :
+                     lowAlive - (lowRow >= 0 ? aliens.rowAlive(lowRow) : 0));
+
+    value += LOW_ALIEN_BONUS*lowKilled;
+
+    value -= LIFE_PENALTY*(startLives - game.getLives());
+
+    if (game.isGameOver())
+      value -= GAME_OVER_PENALTY;
+
+    return value;
+  }
+
+ private:
+  using Workers = std::vector<std::unique_ptr<Worker>>;
+  using Threads = std::vector<std::thread>;
+
+  Params                  params_;
+  CScriptedPolicy         scripted_;
+  Workers                 workers_;
+  Threads                 threads_;
+  std::mutex              mutex_;
+  std::condition_variable startCv_;
+  std::condition_variable doneCv_;
+  long                    generation_  { 0 };
+  int                     numBusy_     { 0 };
+  bool                    quit_        { false };
+  const CSpaceInvaders   *root_        { nullptr };
+  Clock::time_point       deadline_;
+  std::atomic<int>        nextRollout_ { 0 };
+  uint64_t                seed_        { 0 };
+  long                    decision_    { 0 };
+  long                    numRollouts_ { 0 };
+  double                  searchTime_  { 0.0 };
+};
+
+#endif
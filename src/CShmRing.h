@@ -0,0 +1,173 @@
+#ifndef CShmRing_H
+#define CShmRing_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Single producer/single consumer ring of fixed size slots placed in (shared)
+// memory supplied by the caller.
+//
+// The producer writes directly into the slot returned by beginWrite and
+// publishes it with endWrite; the consumer reads the slot in place between
+// beginRead and endRead, so no data is copied. Blocking waits use a (process
+// shared) futex on the head/tail counters and wakes are only issued when the
+// other side has flagged that it is sleeping.
+class CShmRing {
+ private:
+  enum { MAGIC = 0x474e5253 }; // "SRNG"
+
+  struct Header {
+    uint32_t magic;
+    uint32_t numSlots;
+    uint32_t slotSize;
+    uint32_t pad;
+
+    alignas(64) std::atomic<uint32_t> head;         // slots written
+                std::atomic<uint32_t> headWaiters;  // consumers sleeping on head
+    alignas(64) std::atomic<uint32_t> tail;         // slots read
+                std::atomic<uint32_t> tailWaiters;  // producers sleeping on tail
+  };
+
+  static_assert(std::atomic<uint32_t>::is_always_lock_free, "futex needs lock free atomics");
+
+ public:
+  // bytes needed for ring of numSlots slots (slot size rounded to cache line)
+  static size_t memorySize(uint32_t numSlots, uint32_t slotSize) {
+    return headerSize() + size_t(numSlots)*alignSize(slotSize);
+  }
+
+  CShmRing() { }
+
+  // initialize new ring in memory (creator side)
+  void init(void *mem, uint32_t numSlots, uint32_t slotSize) {
+    header_ = new (mem) Header;
+
+    header_->magic    = MAGIC;
+    header_->numSlots = numSlots;
+    header_->slotSize = alignSize(slotSize);
+    header_->pad      = 0;
+
+    header_->head       .store(0);
+    header_->headWaiters.store(0);
+    header_->tail       .store(0);
+    header_->tailWaiters.store(0);
+
+    slots_ = static_cast<char *>(mem) + headerSize();
+  }
+
+  // attach to ring initialized by another process
+  bool attach(void *mem) {
+    Header *header = static_cast<Header *>(mem);
+
+    if (header->magic != MAGIC || header->numSlots == 0)
+      return false;
+
+    header_ = header;
+    slots_  = static_cast<char *>(mem) + headerSize();
+
+    return true;
+  }
+
+  bool isValid() const { return header_; }
+
+  uint32_t numSlots() const { return header_->numSlots; }
+  uint32_t slotSize() const { return header_->slotSize; }
+
+  //---
+
+  // producer: next free slot (waits while full, nullptr if full and ! wait)
+  void *beginWrite(bool wait=true) {
+    uint32_t head = header_->head.load(std::memory_order_relaxed);
+
+    for (;;) {
+      uint32_t tail = header_->tail.load(std::memory_order_acquire);
+
+      if (head - tail < header_->numSlots)
+        break;
+
+      if (! wait) return nullptr;
+
+      waitChange(header_->tail, header_->tailWaiters, tail);
+    }
+
+    return slot(head);
+  }
+
+  // producer: publish slot returned by beginWrite
+  void endWrite() {
+    header_->head.fetch_add(1, std::memory_order_seq_cst);
+
+    if (header_->headWaiters.load(std::memory_order_seq_cst))
+      wake(header_->head);
+  }
+
+  // consumer: oldest unread slot (waits while empty, nullptr if empty and ! wait)
+  void *beginRead(bool wait=true) {
+    uint32_t tail = header_->tail.load(std::memory_order_relaxed);
+
+    for (;;) {
+      uint32_t head = header_->head.load(std::memory_order_acquire);
+
+      if (head != tail)
+        break;
+
+      if (! wait) return nullptr;
+
+      waitChange(header_->head, header_->headWaiters, head);
+    }
+
+    return slot(tail);
+  }
+
+  // consumer: release slot returned by beginRead
+  void endRead() {
+    header_->tail.fetch_add(1, std::memory_order_seq_cst);
+
+    if (header_->tailWaiters.load(std::memory_order_seq_cst))
+      wake(header_->tail);
+  }
+
+ private:
+  static size_t alignSize(size_t size) { return (size + 63) & ~size_t(63); }
+
+  static size_t headerSize() { return alignSize(sizeof(Header)); }
+
+  char *slot(uint32_t i) const {
+    return slots_ + size_t(i % header_->numSlots)*header_->slotSize;
+  }
+
+  // sleep until value no longer equals old
+  static void waitChange(std::atomic<uint32_t> &value, std::atomic<uint32_t> &waiters,
+                         uint32_t old) {
+    // spin briefly before sleeping (replies usually arrive within microseconds)
+    for (int i = 0; i < 256; ++i) {
+      if (value.load(std::memory_order_acquire) != old)
+        return;
+    }
+
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+
+    if (value.load(std::memory_order_seq_cst) == old)
+      syscall(SYS_futex, reinterpret_cast<uint32_t *>(&value), FUTEX_WAIT, old,
+              nullptr, nullptr, 0);
+
+    waiters.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  static void wake(std::atomic<uint32_t> &value) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&value), FUTEX_WAKE, INT32_MAX,
+            nullptr, nullptr, 0);
+  }
+
+ private:
+  Header *header_ { nullptr };
+  char   *slots_  { nullptr };
+};
+
+#endif
@@ -1,7 +1,19 @@
+#ifndef CSpaceInvaders_H
+#define CSpaceInvaders_H
+
+#include <cassert>
+#include <cmath>
 #include <cstdio>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <iostream>
+
+#include <CArena.h>
+#include <CLevels.h>
+#include <CSpriteMasks.h>
 
 #define SCREEN_WIDTH  800
 #define SCREEN_HEIGHT 1000
@@ -33,397 +45,1053 @@ struct Rect {
     return true;
   }
 
+  // area covered moving to this rect by a vertical step of dy
+  Rect sweptY(int dy) const {
+    return Rect(x1, std::min(y1, y1 - dy), x2, std::max(y2, y2 - dy));
+  }
+
+  // earliest fraction (0-1) of a vertical step of dy from this rect at which
+  // it overlaps rect (-1 if it does not)
+  double sweepY(int dy, const Rect &rect) const {
+    if (x2 < rect.x1 || x1 > rect.x2)
+      return -1.0;
+
+    if (dy == 0)
+      return (y2 < rect.y1 || y1 > rect.y2 ? -1.0 : 0.0);
+
+    // overlap for t in [t1, t2]
+    double t1 = double(dy > 0 ? rect.y1 - y2 : rect.y2 - y1)/dy;
+    double t2 = double(dy > 0 ? rect.y2 - y1 : rect.y1 - y2)/dy;
+
+    if (t2 < 0.0 || t1 > 1.0)
+      return -1.0;
+
+    return std::max(t1, 0.0);
+  }
+
   int x1 { 0 }, y1 { 0 };
   int x2 { 0 }, y2 { 0 };
 };
 
 //---
 
-struct Util {
-  static double random() {
-    return (1.0*rand())/RAND_MAX;
-  }
+struct Input {
+  bool   left  { false };
+  bool   right { false };
+  bool   fire  { false };
+  double time  { 0.0 }; // time (secs) of last state change
+  int    seq   { 0 };   // sequence number of last state change
 };
 
 //---
 
-class ImageList {
+// deterministic random number generator (xorshift64*), one per game
+class Random {
  public:
-  ImageList() { }
+  Random(uint64_t seed=1) { setSeed(seed); }
 
-  void addImage(Image *i) { images_.push_back(i); }
+  void setSeed(uint64_t seed) {
+    // splitmix64 scramble so nearby seeds give unrelated sequences
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
 
-  void next() { ++ind_; if (ind_ >= int(images_.size())) ind_ = 0; }
+    z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
 
-  void reset() { ind_ = 0; }
+    state_ = z ^ (z >> 31);
 
-  void draw(const Point &p) const {
-    if (! images_.empty())
-      App::drawImage(p.x, p.y, images_[ind_]);
+    if (state_ == 0) state_ = 1;
   }
 
- private:
-  using Images = std::vector<Image *>;
+  uint64_t state() const { return state_; }
+
+  uint64_t next() {
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+
+    return state_*0x2545f4914f6cdd1dULL;
+  }
+
+  // random value in [0, 1)
+  double random() { return (next() >> 11)*(1.0/9007199254740992.0); }
 
-  int    ind_ { 0 };
-  Images images_;
+ private:
+  uint64_t state_ { 1 };
 };
 
 //---
 
-class Graphic {
+// 64 bit hash mixing (splitmix64 finalizer) for game state hashes
+inline uint64_t hashMix(uint64_t h) {
+  h = (h ^ (h >> 30))*0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27))*0x94d049bb133111ebULL;
+
+  return h ^ (h >> 31);
+}
+
+// order dependent combine of value v into hash h
+inline uint64_t hashCombine(uint64_t h, uint64_t v) {
+  return hashMix(h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2)));
+}
+
+// two 32 bit values as one hash input
+inline uint64_t hashPair(int a, int b) {
+  return (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+}
+
+//---
+
+// integer division rounding down/up (b > 0)
+inline int floorDiv(int a, int b) { return (a >= 0 ? a/b : -((-a + b - 1)/b)); }
+inline int ceilDiv (int a, int b) { return -floorDiv(-a, b); }
+
+//---
+
+// 1 bit collision mask of a sprite image (see CSpriteMasks.h), positioned by
+// the top left of the image as drawn. Rows are packed 64 bit words so an
+// overlap test is an AND of shifted words per overlapping row. An empty mask
+// (image without a generated mask) has no pixels so callers fall back to
+// boxes.
+class Mask {
  public:
-  Graphic(const Point &pos, int w, int h) :
-   pos_(pos), w_(w), h_(h) {
+  Mask() { }
+
+  Mask(const SpriteMaskDef &def) :
+   w_(def.w), h_(def.h), words_((def.w + 63)/64), bits_(def.bits) {
   }
 
-  virtual ~Graphic() { }
+  bool isEmpty() const { return bits_ == nullptr; }
 
-  const Point &getPos() const { return pos_; }
+  int width () const { return w_; }
+  int height() const { return h_; }
+
+  // true if this mask at (x1, y1) has a solid pixel over one of mask at (x2, y2)
+  bool overlaps(int x1, int y1, const Mask &mask, int x2, int y2) const {
+    if (x1 + w_ <= x2 || x2 + mask.w_ <= x1) return false;
 
-  void addImage(Image *i) { images_.addImage(i); }
+    int ya = std::max(y1, y2);
+    int yb = std::min(y1 + h_, y2 + mask.h_);
 
-  void nextImage() { images_.next(); }
+    int dx = x2 - x1; // mask column 0 in this mask's columns
 
-  virtual void draw() {
-    if (isDead()) return;
+    for (int y = ya; y < yb; ++y) {
+      const uint64_t *row = mask.bits_ + (y - y2)*mask.words_;
 
-    Point pos(pos_.x - w_/2, pos_.y - h_/2);
+      for (int k = 0; k < mask.words_; ++k) {
+        if (window(y - y1, dx + 64*k) & row[k])
+          return true;
+      }
+    }
 
-    images_.draw(pos);
+    return false;
   }
 
-  void reset() { dead_ = false; }
+  // first offset (0 to |dy|) along a vertical step of dy from (x1, y1) at
+  // which this mask overlaps mask at (x2, y2), or -1 if it does not
+  int sweep(int x1, int y1, int dy, const Mask &mask, int x2, int y2) const {
+    if (x1 + w_ <= x2 || x2 + mask.w_ <= x1) return -1;
 
-  bool isDead() const { return dead_; }
-  void setDead(bool dead=true) { dead_ = dead; }
+    int s = (dy < 0 ? -1 : 1);
 
-  Rect rect() const { return Rect(pos_.x - w_/2, pos_.y - h_/2, pos_.x + w_/2, pos_.y + h_/2); }
+    // offsets at which the rows overlap
+    int o1 = (s > 0 ? y2 - h_ + 1 - y1 : y1 - y2 - mask.h_ + 1);
+    int o2 = (s > 0 ? y2 + mask.h_ - 1 - y1 : y1 + h_ - 1 - y2);
+
+    o1 = std::max(o1, 0);
+    o2 = std::min(o2, std::abs(dy));
+
+    for (int o = o1; o <= o2; ++o) {
+      if (overlaps(x1, y1 + s*o, mask, x2, y2))
+        return o;
+    }
+
+    return -1;
+  }
+
+ private:
+  // 64 columns of row y starting at column x (bit i is column x + i)
+  uint64_t window(int y, int x) const {
+    if (x <= -64 || x >= w_) return 0;
+
+    const uint64_t *row = bits_ + y*words_;
+
+    if (x < 0) return row[0] << -x;
+
+    int k = x >> 6, shift = x & 63;
+
+    uint64_t bits = row[k] >> shift;
+
+    if (shift != 0 && k + 1 < words_)
+      bits |= row[k + 1] << (64 - shift);
+
+    return bits;
+  }
 
- protected:
-  Point     pos_  { 0, 0 };
-  ImageList images_;
-  int       w_    { 0 } ;
-  int       h_    { 0 } ;
-  bool      dead_ { false };
+ private:
+  int             w_     { 0 };
+  int             h_     { 0 };
+  int             words_ { 0 }; // per row
+  const uint64_t *bits_  { nullptr };
 };
 
 //---
 
-class ExplodeGraphic : public Graphic {
+// Interned game assets.
+//
+// Images and sounds are named by integer handles (ImageId, SoundId) into a
+// table of file names and are all loaded through App once per process, the
+// first time a game is created. Game objects then just index the resolved
+// arrays, so creating, copying or resetting them does no filename lookups.
+// Each image's collision mask is resolved from the compiled in masks at the
+// same time (the same for every backend, so play does not depend on one).
+class Assets {
  public:
-  ExplodeGraphic(const Point &pos, int w, int h) :
-   Graphic(pos, w, h) {
-  }
+  enum ImageId {
+    IMAGE_PLAYER,
+    IMAGE_PLAYER_BULLET,
+    IMAGE_ALIEN_BULLET,
+    IMAGE_MYSTERY,
+    IMAGE_INVADER1A,
+    IMAGE_INVADER1B,
+    IMAGE_INVADER2A,
+    IMAGE_INVADER2B,
+    IMAGE_INVADER3A,
+    IMAGE_INVADER3B,
+    IMAGE_BASE, // first base cell image (see baseImage)
+    NUM_IMAGES = IMAGE_BASE + 4*2*4
+  };
 
-  bool isExploding() const { return exploding_ > 0; }
+  enum SoundId {
+    SOUND_SHOOT,
+    SOUND_EXPLOSION,
+    SOUND_INVADER_KILLED,
+    NUM_SOUNDS
+  };
 
-  void setExploding() { exploding_ = 4; }
+ public:
+  static Image *image(int id) { return instance().images_[id]; }
 
-  void reset() {
-    Graphic::reset();
+  static Sound *sound(SoundId id) { return instance().sounds_[id]; }
 
-    exploding_ = 0;
-  }
+  static const Mask &mask(int id) { return instance().masks_[id]; }
 
-  virtual void draw() {
-    if (isExploding())
-      explodeImages_.draw(Point(pos_.x - 24, pos_.y - 24));
-    else
-      Graphic::draw();
+  // image of base cell (row, col) after taking hits (0-3)
+  static int baseImage(int hits, int row, int col) { return IMAGE_BASE + (hits*2 + row)*4 + col; }
+
+  // resolve all handles now (otherwise done on first use)
+  static void load() { (void) instance(); }
+
+ private:
+  Assets() {
+    static const char *imageNames[NUM_IMAGES] = {
+      "images/player1a.png",
+      "images/bullet1a.png",
+      "images/bullet2a.png",
+      "images/mystery1a.png",
+      "images/invader1a.png",
+      "images/invader1b.png",
+      "images/invader2a.png",
+      "images/invader2b.png",
+      "images/invader3a.png",
+      "images/invader3b.png",
+
+      // base cells by hits, row, col
+      "images/base1a_1_1.png", "images/base1a_2_1.png", "images/base1a_3_1.png", "images/base1a_4_1.png",
+      "images/base1a_1_2.png", "images/base1a_2_2.png", "images/base1a_3_2.png", "images/base1a_4_2.png",
+      "images/base1a_1_1.png", "images/base1b_2_1.png", "images/base1b_3_1.png", "images/base1b_4_1.png",
+      "images/base1b_1_2.png", "images/base1b_2_2.png", "images/base1b_3_2.png", "images/base1b_4_2.png",
+      "images/base1c_1_1.png", "images/base1c_2_1.png", "images/base1c_3_1.png", "images/base1c_4_1.png",
+      "images/base1c_1_2.png", "images/base1c_2_2.png", "images/base1c_3_2.png", "images/base1c_4_2.png",
+      "images/base1d_1_1.png", "images/base1d_2_1.png", "images/base1d_3_1.png", "images/base1d_4_1.png",
+      "images/base1d_1_2.png", "images/base1d_2_2.png", "images/base1d_3_2.png", "images/base1d_4_2.png",
+    };
+
+    static const char *soundNames[NUM_SOUNDS] = {
+      "sounds/shoot.wav",
+      "sounds/explosion.wav",
+      "sounds/invaderkilled.wav",
+    };
+
+    for (int i = 0; i < NUM_IMAGES; ++i) {
+      images_[i] = App::loadImage(imageNames[i]);
+
+      masks_[i] = findMask(imageNames[i]);
+    }
+
+    for (int i = 0; i < NUM_SOUNDS; ++i)
+      sounds_[i] = App::loadSound(soundNames[i]);
   }
 
-  virtual void update() {
-    if (isExploding()) {
-      --exploding_;
+  // loaded once (thread safe) on first use
+  static const Assets &instance() {
+    static Assets assets;
 
-      if (exploding_ == 0)
-        setDead();
+    return assets;
+  }
 
-      return;
+  static Mask findMask(const char *name) {
+    for (int i = 0; i < NUM_SPRITE_MASKS; ++i) {
+      if (strcmp(spriteMaskDefs[i].name, name) == 0)
+        return Mask(spriteMaskDefs[i]);
     }
+
+    std::cerr << "Error: No collision mask for image '" << name << "'" << std::endl;
+
+    return Mask();
   }
 
- protected:
-  int       exploding_ { 0 };
-  ImageList explodeImages_;
+ private:
+  Image *images_[NUM_IMAGES] = {};
+  Sound *sounds_[NUM_SOUNDS] = {};
+  Mask   masks_ [NUM_IMAGES];
 };
 
 //---
 
-class Bullet : public Graphic {
- public:
-  Bullet(const Point &pos, int w, int h) :
-   Graphic(pos, w, h) {
-  }
+// animation frames (and their collision masks) shared by all entities of a type
+struct Sprite {
+  enum { MAX_IMAGES = 2 };
 
-  virtual ~Bullet() { }
+  Image      *images[MAX_IMAGES] = {};
+  const Mask *masks [MAX_IMAGES] = {};
+  int         num { 0 };
 
-  virtual void update() = 0;
+  void addImage(int id) {
+    if (num >= MAX_IMAGES) return;
+
+    images[num] = Assets::image(id);
+    masks [num] = &Assets::mask(id);
+
+    ++num;
+  }
 };
 
 //---
 
-class Alien;
+// Structure of arrays entity components.
+//
+// Component arrays are allocated once (fixed capacity) from the game arena.
+// Systems iterate them linearly and dead entities are compacted out at the
+// end of each tick so they are never visited again.
+class EntityStore {
+ public:
+  EntityStore() { }
 
-class AlienBullet : public Bullet {
- private:
-  enum { DY = 8 };
+  void init(CArena &arena, int capacity) {
+    capacity_ = capacity;
+    size_     = 0;
 
- public:
-  AlienBullet(Alien *alien, const Point &pos) :
-   Bullet(pos, 9, 26), alien_(alien) {
-    addImage(App::loadImage("images/bullet2a.png"));
+    x          = arena.createArray<int    >(capacity);
+    y          = arena.createArray<int    >(capacity);
+    w          = arena.createArray<short  >(capacity);
+    h          = arena.createArray<short  >(capacity);
+    dx         = arena.createArray<short  >(capacity);
+    dy         = arena.createArray<short  >(capacity);
+    type       = arena.createArray<uint8_t>(capacity);
+    frame      = arena.createArray<uint8_t>(capacity);
+    frameTicks = arena.createArray<uint8_t>(capacity);
+    explode    = arena.createArray<uint8_t>(capacity);
+    dead       = arena.createArray<uint8_t>(capacity);
   }
 
-  Alien *alien() const { return alien_; }
+  int size() const { return size_; }
 
-  void update() {
-    pos_.y += DY;
+  int capacity() const { return capacity_; }
+
+  bool isEmpty() const { return size_ == 0; }
+  bool isFull () const { return size_ >= capacity_; }
 
-    if (pos_.y >= SCREEN_HEIGHT)
-      setDead();
+  // add entity at centre point (returns index or -1 if full)
+  int add(int x1, int y1, int w1, int h1, int type1=0) {
+    if (isFull()) return -1;
+
+    int i = size_++;
+
+    x         [i] = x1;
+    y         [i] = y1;
+    w         [i] = w1;
+    h         [i] = h1;
+    dx        [i] = 0;
+    dy        [i] = 0;
+    type      [i] = type1;
+    frame     [i] = 0;
+    frameTicks[i] = 0;
+    explode   [i] = 0;
+    dead      [i] = 0;
+
+    return i;
   }
 
- private:
-  Alien *alien_ { nullptr };
-};
+  void clear() { size_ = 0; }
 
-//---
+  // copy entities from store of same capacity
+  void copy(const EntityStore &store) {
+    assert(store.capacity_ == capacity_);
 
-class Player;
+    size_ = store.size_;
 
-class PlayerBullet : public Bullet {
- private:
-  enum { DY = 32 };
+    std::copy(store.x         , store.x          + size_, x         );
+    std::copy(store.y         , store.y          + size_, y         );
+    std::copy(store.w         , store.w          + size_, w         );
+    std::copy(store.h         , store.h          + size_, h         );
+    std::copy(store.dx        , store.dx         + size_, dx        );
+    std::copy(store.dy        , store.dy         + size_, dy        );
+    std::copy(store.type      , store.type       + size_, type      );
+    std::copy(store.frame     , store.frame      + size_, frame     );
+    std::copy(store.frameTicks, store.frameTicks + size_, frameTicks);
+    std::copy(store.explode   , store.explode    + size_, explode   );
+    std::copy(store.dead      , store.dead       + size_, dead      );
+  }
 
- public:
-  PlayerBullet(Player *player, const Point &pos) :
-   Bullet(pos, 4, 26), player_(player) {
-    addImage(App::loadImage("images/bullet1a.png"));
+  bool isAlive(int i) const { return ! dead[i] && ! explode[i]; }
+
+  Rect rect(int i) const {
+    int hw = w[i]/2, hh = h[i]/2;
+
+    return Rect(x[i] - hw, y[i] - hh, x[i] + hw, y[i] + hh);
   }
 
-  Player *player() const { return player_; }
+  // remove dead entities (keeping order)
+  void compact() {
+    int j = 0;
 
-  void update() {
-    pos_.y -= DY;
+    for (int i = 0; i < size_; ++i) {
+      if (dead[i]) continue;
 
-    if (pos_.y < 10)
-      setDead();
+      if (i != j) {
+        x         [j] = x         [i];
+        y         [j] = y         [i];
+        w         [j] = w         [i];
+        h         [j] = h         [i];
+        dx        [j] = dx        [i];
+        dy        [j] = dy        [i];
+        type      [j] = type      [i];
+        frame     [j] = frame     [i];
+        frameTicks[j] = frameTicks[i];
+        explode   [j] = explode   [i];
+        dead      [j] = 0;
+      }
+
+      ++j;
+    }
+
+    size_ = j;
   }
 
+ public:
+  int     *x          { nullptr }; // position (centre)
+  int     *y          { nullptr };
+  short   *w          { nullptr }; // hit box size
+  short   *h          { nullptr };
+  short   *dx         { nullptr }; // velocity
+  short   *dy         { nullptr };
+  uint8_t *type       { nullptr }; // sprite index
+  uint8_t *frame      { nullptr }; // animation frame
+  uint8_t *frameTicks { nullptr }; // ticks to next animation frame
+  uint8_t *explode    { nullptr }; // explosion ticks left (0 if not exploding)
+  uint8_t *dead       { nullptr }; // dead (removed by compact)
+
  private:
-  Player *player_ { nullptr };
+  int capacity_ { 0 };
+  int size_     { 0 };
 };
 
 //---
 
-class CSpaceInvaders;
+// Structure of arrays explosion particle pool.
+//
+// Like EntityStore the arrays are allocated once (fixed capacity) from the
+// game arena and bursts beyond capacity are dropped. update integrates every
+// particle with branch free loops over the component arrays, which the
+// compiler vectorises, then removes expired particles by moving the last
+// particle into their slot (draw order does not matter).
+class ParticleStore {
+ public:
+  enum { GRAVITY_SCALE = 16 }; // gravity is 1/GRAVITY_SCALE pixels per tick per tick
+  enum { BLOCK         = 16 }; // update granularity (capacity is rounded up to it)
 
-class AlienManager {
- private:
-  enum { NUM_BULLETS = 5 };
+  ParticleStore() { }
 
- public:
-  AlienManager(CSpaceInvaders *invaders) :
-   invaders_(invaders) {
-    for (int y = 0; y < 5; ++y)
-      row_y_[y] = y*60 + 110;
+  void init(CArena &arena, int capacity) {
+    capacity_ = (capacity + BLOCK - 1)/BLOCK*BLOCK;
+    size_     = 0;
 
-    bullets_.resize(NUM_BULLETS);
+    capacity = capacity_;
 
-    for (uint i = 0; i < NUM_BULLETS; ++i)
-      bullets_[i] = nullptr;
+    x     = arena.createArray<float  >(capacity);
+    y     = arena.createArray<float  >(capacity);
+    dx    = arena.createArray<float  >(capacity);
+    dy    = arena.createArray<float  >(capacity);
+    life  = arena.createArray<uint8_t>(capacity);
+    color = arena.createArray<uint8_t>(capacity);
   }
 
-  void reset() {
-    speed_ = 8;
+  int size() const { return size_; }
 
-    for (int y = 0; y < 5; ++y)
-      row_y_[y] = y*60 + 100;
+  int capacity() const { return capacity_; }
 
-    for (uint i = 0; i < NUM_BULLETS; ++i) {
-      delete bullets_[i];
+  bool isEmpty() const { return size_ == 0; }
+  bool isFull () const { return size_ >= capacity_; }
 
-      bullets_[i] = nullptr;
-    }
-  }
+  // add particle (returns index or -1 if full)
+  int add(float x1, float y1, float dx1, float dy1, int life1, int color1) {
+    if (isFull()) return -1;
+
+    int i = size_++;
 
-  CSpaceInvaders *getInvaders() const { return invaders_; }
+    x    [i] = x1;
+    y    [i] = y1;
+    dx   [i] = dx1;
+    dy   [i] = dy1;
+    life [i] = uint8_t(std::max(life1, 1));
+    color[i] = uint8_t(color1);
 
-  int getWidth() const { return w_; }
+    return i;
+  }
 
-  int getRowY(int row) const { return row_y_[row]; }
+  void clear() { size_ = 0; }
 
-  int getDir() const { return dir_; }
+  // copy particles from store of same capacity
+  void copy(const ParticleStore &store) {
+    assert(store.capacity_ == capacity_);
 
-  int getSpeed() const { return speed_/4; }
+    size_ = store.size_;
 
-  void setNeedsIncRow(bool b=true) { needsIncRow_ = b; }
+    std::copy(store.x    , store.x     + size_, x    );
+    std::copy(store.y    , store.y     + size_, y    );
+    std::copy(store.dx   , store.dx    + size_, dx   );
+    std::copy(store.dy   , store.dy    + size_, dy   );
+    std::copy(store.life , store.life  + size_, life );
+    std::copy(store.color, store.color + size_, color);
+  }
 
-  void preUpdate();
+  // advance all particles one tick
+  void update() {
+    // whole blocks (slots past size are spare capacity) so the fixed length
+    // inner loops vectorise at -O2
+    int nb = (size_ + BLOCK - 1)/BLOCK;
 
-  void postUpdate();
+    for (int b = 0; b < nb; ++b) {
+      int i = b*BLOCK;
 
-  void update();
+      integrate(x + i, y + i, dx + i, dy + i, life + i);
+    }
 
-  void incAlive() { ++numAlive_; }
+    // remove expired
+    for (int i = 0; i < size_; ) {
+      if (life[i] != 0) { ++i; continue; }
 
-  void fire(Alien *alien);
+      int j = --size_;
 
-  void draw() {
-    for (uint i = 0; i < NUM_BULLETS; ++i) {
-      if (bullets_[i])
-        bullets_[i]->draw();
+      x    [i] = x    [j];
+      y    [i] = y    [j];
+      dx   [i] = dx   [j];
+      dy   [i] = dy   [j];
+      life [i] = life [j];
+      color[i] = color[j];
+    }
+  }
+
+ private:
+  static void integrate(float *__restrict x, float *__restrict y, const float *__restrict dx,
+                        float *__restrict dy, uint8_t *__restrict life) {
+    const float gravity = 1.0f/GRAVITY_SCALE;
+
+    for (int i = 0; i < BLOCK; ++i) {
+      x [i] += dx[i];
+      y [i] += dy[i];
+      dy[i] += gravity;
     }
+
+    for (int i = 0; i < BLOCK; ++i)
+      life[i] = uint8_t(life[i] - 1);
   }
 
-  void checkHit(PlayerBullet *bullet);
+ public:
+  float   *x     { nullptr }; // position
+  float   *y     { nullptr };
+  float   *dx    { nullptr }; // velocity
+  float   *dy    { nullptr };
+  uint8_t *life  { nullptr }; // ticks left
+  uint8_t *color { nullptr }; // particleColors index
 
  private:
-  typedef std::vector<AlienBullet *> BulletList;
-
-  CSpaceInvaders *invaders_    { nullptr };
-  int             row_y_[5];
-  int             dir_         { 1 };
-  int             speed_       { 8 };
-  int             w_           { 48 };
-  int             numAlive_    { 0 };
-  bool            needsIncRow_ { false };
-  BulletList      bullets_;
+  int capacity_ { 0 };
+  int size_     { 0 };
+};
+
+// explosion particle colours (0xRRGGBB)
+enum ParticleColor {
+  PARTICLE_WHITE,
+  PARTICLE_RED,
+  PARTICLE_GREEN
 };
 
+constexpr uint32_t particleColors[] = { 0xffffff, 0xff4040, 0x20ff20 };
+
 //---
 
-class Alien : public ExplodeGraphic {
+// Uniform grid broadphase over the screen for an EntityStore.
+//
+// build buckets the store's alive entities by centre cell (counting sort into
+// fixed arrays from the game arena, no allocation per tick). query visits the
+// entities whose centre cell lies within the query rect expanded by the
+// largest entity half size and step seen by build, so every entity which can
+// overlap (or be swept into) the rect is visited. Positions outside the
+// screen clamp to the border cells.
+class SpatialGrid {
  public:
-  Alien(AlienManager *mgr, int col, int row, const Point &pos, int w, int h) :
-   ExplodeGraphic(pos, w, h), mgr_(mgr), col_(col), row_(row) {
-    dieSound_ = App::loadSound("sounds/invaderkilled.wav");
+  enum { CELL_SIZE = 64 };
+  enum { NX        = (SCREEN_WIDTH  + CELL_SIZE - 1)/CELL_SIZE };
+  enum { NY        = (SCREEN_HEIGHT + CELL_SIZE - 1)/CELL_SIZE };
+
+  SpatialGrid() { }
 
-    explodeImages_.addImage(App::loadImage("images/explode1.png"));
+  void init(CArena &arena, int capacity) {
+    cellStart_ = arena.createArray<int>(NX*NY + 1);
+    items_     = arena.createArray<int>(capacity);
+    cells_     = arena.createArray<int>(capacity);
   }
 
-  virtual ~Alien() { }
+  void build(const EntityStore &store) {
+    std::fill(cellStart_, cellStart_ + NX*NY + 1, 0);
 
-  virtual int getScore() const = 0;
+    marginX_ = 0;
+    marginY_ = 0;
 
-  void reset() {
-    ExplodeGraphic::reset();
+    int n = store.size();
+
+    for (int i = 0; i < n; ++i) {
+      if (! store.isAlive(i)) { cells_[i] = -1; continue; }
+
+      int c = cellX(store.x[i]) + cellY(store.y[i])*NX;
+
+      cells_[i] = c;
+
+      ++cellStart_[c + 1];
+
+      marginX_ = std::max(marginX_, store.w[i]/2 + std::abs(int(store.dx[i])));
+      marginY_ = std::max(marginY_, store.h[i]/2 + std::abs(int(store.dy[i])));
+    }
+
+    for (int c = 0; c < NX*NY; ++c)
+      cellStart_[c + 1] += cellStart_[c];
+
+    // fill cells (keeps index order within a cell)
+    for (int i = 0; i < n; ++i) {
+      if (cells_[i] >= 0)
+        items_[cellStart_[cells_[i]]++] = i;
+    }
 
-    imageCount_ = 0;
+    // filling advanced each start to the next cell's start so shift back
+    for (int c = NX*NY; c > 0; --c)
+      cellStart_[c] = cellStart_[c - 1];
 
-    pos_.x = 34*(2*col_ + 1);
+    cellStart_[0] = 0;
   }
 
-  void update();
+  // call f(i) for candidate entities near rect
+  template<typename F>
+  void query(const Rect &rect, F f) const {
+    int cx1 = cellX(rect.x1 - marginX_), cx2 = cellX(rect.x2 + marginX_);
+    int cy1 = cellY(rect.y1 - marginY_), cy2 = cellY(rect.y2 + marginY_);
 
-  void draw() {
-    pos_.y = mgr_->getRowY(row_);
+    for (int cy = cy1; cy <= cy2; ++cy) {
+      for (int cx = cx1; cx <= cx2; ++cx) {
+        int c = cx + cy*NX;
 
-    ExplodeGraphic::draw();
+        for (int k = cellStart_[c]; k < cellStart_[c + 1]; ++k)
+          f(items_[k]);
+      }
+    }
   }
 
-  void checkHit(PlayerBullet *bullet);
+ private:
+  static int cellX(int x) { return std::min(std::max(x, 0)/CELL_SIZE, int(NX) - 1); }
+  static int cellY(int y) { return std::min(std::max(y, 0)/CELL_SIZE, int(NY) - 1); }
 
  private:
-  AlienManager *mgr_        { nullptr };
-  int           col_        { 0 };
-  int           row_        { 0 };
-  int           imageCount_ { 4 };
-  Sound        *dieSound_   { nullptr };
+  int *cellStart_ { nullptr }; // first item of each cell (NX*NY + 1)
+  int *items_     { nullptr }; // entity indices by cell
+  int *cells_     { nullptr }; // cell of each entity (-1 if not alive)
+  int  marginX_   { 0 };
+  int  marginY_   { 0 };
 };
 
 //---
 
-class Alien1 : public Alien {
- public:
-  Alien1(AlienManager *mgr, int col, int row, const Point &pos) :
-   Alien(mgr, col, row, pos, 35, 35) {
-    addImage(App::loadImage("images/invader1a.png"));
-    addImage(App::loadImage("images/invader1b.png"));
-  }
+// alien kinds (add new kinds here)
+struct AlienType {
+  int w;
+  int h;
+  int score;
+  int image1; // Assets::ImageId
+  int image2;
+};
 
-  int getScore() const { return 30; }
+constexpr AlienType alienTypes[] = {
+  { 35, 35, 30, Assets::IMAGE_INVADER1A, Assets::IMAGE_INVADER1B },
+  { 48, 35, 20, Assets::IMAGE_INVADER2A, Assets::IMAGE_INVADER2B },
+  { 52, 35, 10, Assets::IMAGE_INVADER3A, Assets::IMAGE_INVADER3B },
 };
 
+constexpr int NUM_ALIEN_TYPES = sizeof(alienTypes)/sizeof(alienTypes[0]);
+
 //---
 
-class Alien2 : public Alien {
+// Alien formation.
+//
+// Aliens are the cells of the wave's rows x cols grid, placed at fixed
+// offsets from a single formation origin, so moving or dropping the
+// formation is O(1) and a position is always origin plus offset (never
+// stale). Live (hittable) cells are kept in a bitmask, a row of 64 bit words
+// per grid row, and exploding cells in another. Per row and column live
+// counts give the live count and the extents (leftmost, rightmost and bottom
+// aliens), updated as aliens are killed rather than found by a scan.
+//
+// Cells are visited in index order (row*cols + col), the order the aliens
+// were added, by forEachAlive and forEachPresent. query maps a rect into the
+// grid arithmetically to the range of cells which can overlap it.
+class AlienFormation {
  public:
-  Alien2(AlienManager *mgr, int col, int row, const Point &pos) :
-   Alien(mgr, col, row, pos, 48, 35) {
-    addImage(App::loadImage("images/invader2a.png"));
-    addImage(App::loadImage("images/invader2b.png"));
+  enum { ANIMATE_TICKS = 4 };
+  enum { EDGE_W        = 48 }; // width kept clear of the screen edges
+  enum { MAX_ROWS      = WaveDef::MAX_FORMATION_ROWS };
+
+  AlienFormation() { }
+
+  // allocate for formations of up to capacity aliens
+  void init(CArena &arena, int capacity) {
+    capacity_ = capacity;
+
+    int numWords = capacity/64 + MAX_ROWS;
+
+    alive_     = arena.createArray<uint64_t>(numWords);
+    exploding_ = arena.createArray<uint64_t>(numWords);
+    explode_   = arena.createArray<uint8_t >(capacity);
+    colAlive_  = arena.createArray<int     >(capacity);
+  }
+
+  // copy formation from one of same capacity
+  void copy(const AlienFormation &formation) {
+    assert(formation.capacity_ == capacity_);
+
+    rows_         = formation.rows_;
+    cols_         = formation.cols_;
+    words_        = formation.words_;
+    colX_         = formation.colX_;
+    colDX_        = formation.colDX_;
+    rowY_         = formation.rowY_;
+    rowDY_        = formation.rowDY_;
+    marginX_      = formation.marginX_;
+    marginY_      = formation.marginY_;
+    dir_          = formation.dir_;
+    speed_        = formation.speed_;
+    x_            = formation.x_;
+    y_            = formation.y_;
+    frame_        = formation.frame_;
+    frameTicks_   = formation.frameTicks_;
+    numAlive_     = formation.numAlive_;
+    numExploding_ = formation.numExploding_;
+    minCol_       = formation.minCol_;
+    maxCol_       = formation.maxCol_;
+    minRow_       = formation.minRow_;
+    maxRow_       = formation.maxRow_;
+
+    int numWords = rows_*words_;
+
+    std::copy(formation.alive_    , formation.alive_     + numWords    , alive_    );
+    std::copy(formation.exploding_, formation.exploding_ + numWords    , exploding_);
+    std::copy(formation.explode_  , formation.explode_   + rows_*cols_ , explode_  );
+    std::copy(formation.colAlive_ , formation.colAlive_  + cols_       , colAlive_ );
+    std::copy(formation.rowAlive_ , formation.rowAlive_  + rows_       , rowAlive_ );
+    std::copy(formation.rowType_  , formation.rowType_   + rows_       , rowType_  );
+  }
+
+  // fill grid for wave (direction carries over from the previous wave)
+  void reset(const WaveDef &wave) {
+    rows_  = std::min(wave.rows, int(MAX_ROWS));
+    cols_  = std::min(wave.cols, capacity_/std::max(rows_, 1));
+    words_ = (cols_ + 63)/64;
+    colX_  = wave.colX;
+    colDX_ = wave.colDX;
+    rowY_  = wave.rowY;
+    rowDY_ = wave.rowDY;
+
+    speed_      = wave.speed;
+    x_          = 0;
+    y_          = 0;
+    frame_      = 0;
+    frameTicks_ = ANIMATE_TICKS;
+
+    marginX_ = 0;
+    marginY_ = 0;
+
+    for (int r = 0; r < rows_; ++r) {
+      int rowType = wave.rowTypes[std::min(r, int(WaveDef::MAX_ROWS) - 1)];
+
+      rowType_[r] = uint8_t(std::min(std::max(rowType, 0), NUM_ALIEN_TYPES - 1));
+
+      marginX_ = std::max(marginX_, alienTypes[rowType_[r]].w/2);
+      marginY_ = std::max(marginY_, alienTypes[rowType_[r]].h/2);
+
+      rowAlive_[r] = cols_;
+
+      for (int k = 0; k < words_; ++k) {
+        int n = std::min(cols_ - 64*k, 64);
+
+        alive_    [r*words_ + k] = (n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1);
+        exploding_[r*words_ + k] = 0;
+      }
+    }
+
+    std::fill(explode_ , explode_  + rows_*cols_, 0);
+    std::fill(colAlive_, colAlive_ + cols_      , rows_);
+
+    numAlive_     = rows_*cols_;
+    numExploding_ = 0;
+
+    minCol_ = 0; maxCol_ = cols_ - 1;
+    minRow_ = 0; maxRow_ = rows_ - 1;
   }
 
-  int getScore() const { return 20; }
-};
+  //---
 
-//---
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
 
-class Alien3 : public Alien {
- public:
-  Alien3(AlienManager *mgr, int col, int row, const Point &pos) :
-   Alien(mgr, col, row, pos, 52, 35) {
-    addImage(App::loadImage("images/invader3a.png"));
-    addImage(App::loadImage("images/invader3b.png"));
+  // live aliens
+  int numAlive() const { return numAlive_; }
+
+  // live and exploding aliens
+  int size() const { return numAlive_ + numExploding_; }
+
+  int dir  () const { return dir_; }
+  int frame() const { return frame_; }
+
+  void setDir(int dir) { dir_ = dir; }
+
+  int getSpeed() const { return speed_/4; }
+
+  // cell accessors (position is the centre)
+  int x(int i) const { return colX_ + x_ + (i % cols_)*colDX_; }
+  int y(int i) const { return rowY_ + y_ + (i / cols_)*rowDY_; }
+
+  // offset from formation origin
+  int offsetX(int i) const { return colX_ + (i % cols_)*colDX_; }
+  int offsetY(int i) const { return rowY_ + (i / cols_)*rowDY_; }
+
+  int type(int i) const { return rowType_[i / cols_]; }
+
+  int w(int i) const { return alienTypes[type(i)].w; }
+  int h(int i) const { return alienTypes[type(i)].h; }
+
+  // explosion ticks left (0 if not exploding)
+  int explode(int i) const { return explode_[i]; }
+
+  bool isAlive(int i) const { return bit(alive_, i); }
+
+  Rect rect(int i) const {
+    int hw = w(i)/2, hh = h(i)/2;
+
+    return Rect(x(i) - hw, y(i) - hh, x(i) + hw, y(i) + hh);
   }
 
-  int getScore() const { return 10; }
-};
+  // extents of live aliens' centres (only when numAlive > 0)
+  int leftX  () const { return x(0) + std::min(minCol_*colDX_, maxCol_*colDX_); }
+  int rightX () const { return x(0) + std::max(minCol_*colDX_, maxCol_*colDX_); }
+  int bottomY() const { return y(0) + std::max(minRow_*rowDY_, maxRow_*rowDY_); }
 
-//---
+  // lowest row with live aliens (only when numAlive > 0) and live count of row
+  int bottomRow() const { return (rowDY_ >= 0 ? maxRow_ : minRow_); }
 
-class MysteryAlien : public ExplodeGraphic {
- private:
-  enum { DX = -4 };
+  int rowAlive(int r) const { return rowAlive_[r]; }
 
- public:
-  MysteryAlien(CSpaceInvaders *invaders) :
-   ExplodeGraphic(Point(0, 60), 71, 31), invaders_(invaders) {
-    addImage(App::loadImage("images/mystery1a.png"));
+  //---
+
+  void move(int dx) { x_ += dx; }
 
-    explodeImages_.addImage(App::loadImage("images/explode1.png"));
+  // drop a row and reverse at screen edge
+  void dropRow(int drop, int speedInc) {
+    y_ += drop;
 
-    dieSound_ = App::loadSound("sounds/invaderkilled.wav");
+    dir_ = -dir_;
 
-    dead_ = true;
+    speed_ += speedInc;
   }
 
-  int getScore() const {
-    double r = Util::random();
+  void animate() {
+    if (--frameTicks_ == 0) {
+      ++frame_;
 
-    if      (r < 0.50) return 100;
-    else if (r < 0.80) return 200;
-    else if (r < 0.95) return 300;
-    else               return 400;
+      frameTicks_ = ANIMATE_TICKS;
+    }
   }
 
-  void reset() {
-    ExplodeGraphic::reset();
+  // live alien starts exploding
+  void kill(int i, int explodeTicks) {
+    assert(isAlive(i));
+
+    int r = i / cols_, c = i % cols_;
+
+    setBit(alive_    , i, false);
+    setBit(exploding_, i, true );
+
+    explode_[i] = uint8_t(explodeTicks);
 
-    dead_ = true;
+    --numAlive_;
+    ++numExploding_;
 
-    pos_.x = SCREEN_WIDTH + w_/2;
+    --rowAlive_[r];
+    --colAlive_[c];
+
+    // shrink extents past emptied rows and columns
+    if (numAlive_ == 0) return;
+
+    while (colAlive_[minCol_] == 0) ++minCol_;
+    while (colAlive_[maxCol_] == 0) --maxCol_;
+    while (rowAlive_[minRow_] == 0) ++minRow_;
+    while (rowAlive_[maxRow_] == 0) --maxRow_;
   }
 
-  void update() {
-    ExplodeGraphic::update();
+  // count down exploding alien, returns false when it is gone
+  bool explodeTick(int i) {
+    if (--explode_[i] > 0) return true;
+
+    setBit(exploding_, i, false);
+
+    --numExploding_;
+
+    return false;
+  }
+
+  // call f(i) for live aliens in index order
+  template<typename F>
+  void forEachAlive(F f) const {
+    for (int r = 0; r < rows_; ++r) {
+      if (rowAlive_[r] == 0) continue;
+
+      forEachBit(r, alive_ + r*words_, nullptr, f);
+    }
+  }
+
+  // call f(i) for exploding aliens in index order (f may end the explosion)
+  template<typename F>
+  void forEachExploding(F f) const {
+    if (numExploding_ == 0) return;
+
+    for (int r = 0; r < rows_; ++r)
+      forEachBit(r, exploding_ + r*words_, nullptr, f);
+  }
+
+  // call f(i) for live and exploding aliens in index order
+  template<typename F>
+  void forEachPresent(F f) const {
+    for (int r = 0; r < rows_; ++r)
+      forEachBit(r, alive_ + r*words_, exploding_ + r*words_, f);
+  }
+
+  // call f(i) for live aliens whose rect can overlap rect (in index order)
+  template<typename F>
+  void query(const Rect &rect, F f) const {
+    if (numAlive_ == 0) return;
+
+    // cells whose centre lies within rect expanded by the largest half size
+    int c1 = minCol_, c2 = maxCol_;
+    int r1 = minRow_, r2 = maxRow_;
+
+    if (colDX_ > 0) {
+      c1 = std::max(c1, ceilDiv (rect.x1 - marginX_ - x(0), colDX_));
+      c2 = std::min(c2, floorDiv(rect.x2 + marginX_ - x(0), colDX_));
+    }
 
-    if (isDead()) return;
+    if (rowDY_ > 0) {
+      r1 = std::max(r1, ceilDiv (rect.y1 - marginY_ - y(0), rowDY_));
+      r2 = std::min(r2, floorDiv(rect.y2 + marginY_ - y(0), rowDY_));
+    }
+
+    for (int r = r1; r <= r2; ++r) {
+      if (rowAlive_[r] == 0) continue;
+
+      for (int c = c1; c <= c2; ++c) {
+        int i = r*cols_ + c;
+
+        if (isAlive(i))
+          f(i);
+      }
+    }
+  }
+
+  uint64_t hash() const {
+    uint64_t h = hashMix(hashPair(dir_, speed_));
+
+    h = hashCombine(h, hashPair(x_, y_));
+    h = hashCombine(h, hashPair(frame_, frameTicks_));
+
+    return hashCombine(h, numAlive_);
+  }
+
+ private:
+  bool bit(const uint64_t *bits, int i) const {
+    int r = i / cols_, c = i % cols_;
+
+    return (bits[r*words_ + (c >> 6)] >> (c & 63)) & 1;
+  }
+
+  void setBit(uint64_t *bits, int i, bool b) {
+    int r = i / cols_, c = i % cols_;
 
-    pos_.x += DX;
+    uint64_t m = uint64_t(1) << (c & 63);
 
-    if (pos_.x < 0)
-      setDead();
+    if (b) bits[r*words_ + (c >> 6)] |=  m;
+    else   bits[r*words_ + (c >> 6)] &= ~m;
   }
 
-  void checkHit(PlayerBullet *bullet);
+  // call f for set bits of row r (bits1 | bits2), words read before any call
+  template<typename F>
+  void forEachBit(int r, const uint64_t *bits1, const uint64_t *bits2, F f) const {
+    for (int k = 0; k < words_; ++k) {
+      uint64_t bits = bits1[k] | (bits2 ? bits2[k] : 0);
+
+      while (bits) {
+        int c = 64*k + __builtin_ctzll(bits);
+
+        bits &= bits - 1;
+
+        f(r*cols_ + c);
+      }
+    }
+  }
 
  private:
-  CSpaceInvaders *invaders_ { nullptr };
-  Sound          *dieSound_ { nullptr };
+  int       capacity_     { 0 };
+  int       rows_         { 0 };
+  int       cols_         { 1 };
+  int       words_        { 0 };  // bitmask words per row
+  int       colX_         { 0 };  // cell (0, 0) offset
+  int       colDX_        { 0 };  // cell spacing
+  int       rowY_         { 0 };
+  int       rowDY_        { 0 };
+  int       marginX_      { 0 };  // largest alien half size
+  int       marginY_      { 0 };
+  int       dir_          { 1 };
+  int       speed_        { 8 };
+  int       x_            { 0 };  // origin moved since wave start
+  int       y_            { 0 };
+  int       frame_        { 0 };  // animation frame (all aliens animate together)
+  int       frameTicks_   { ANIMATE_TICKS };
+  int       numAlive_     { 0 };
+  int       numExploding_ { 0 };
+  int       minCol_       { 0 };  // extents of live aliens
+  int       maxCol_       { 0 };
+  int       minRow_       { 0 };
+  int       maxRow_       { 0 };
+  uint64_t *alive_        { nullptr }; // live cells (rows x words)
+  uint64_t *exploding_    { nullptr }; // exploding cells
+  uint8_t  *explode_      { nullptr }; // explosion ticks left per cell
+  int      *colAlive_     { nullptr }; // live cells per column
+  int       rowAlive_[MAX_ROWS] = {};  // live cells per row
+  uint8_t   rowType_ [MAX_ROWS] = {};  // alien type per row
 };
 
 //---
@@ -434,6 +1102,8 @@ class Score {
    pos_(pos) {
   }
 
+  int value() const { return score_; }
+
   void add(int i) { score_ += i; }
 
   void draw() {
@@ -455,38 +1125,35 @@ class Score {
 
 //---
 
-class Player : public Graphic {
+class CSpaceInvaders;
+
+class Player {
  private:
   enum { DX          = 8 };
   enum { NUM_LIVES   = 3 };
-  enum { NUM_BULLETS = 5 };
 
  public:
   Player(CSpaceInvaders *invaders, const Point &pos) :
-   Graphic(pos, 57, 35), invaders_(invaders), lives_(NUM_LIVES),
-   d_(DX), fire_block_(0) {
-    addImage(App::loadImage("images/player1a.png"));
+   invaders_(invaders), startPos_(pos), pos_(pos), lives_(NUM_LIVES), d_(DX), fire_block_(0) {
+  }
 
-    bullets_.resize(NUM_BULLETS);
+  const Point &getPos() const { return pos_; }
 
-    for (uint i = 0; i < NUM_BULLETS; ++i)
-      bullets_[i] = nullptr;
+  int getHeight() const { return h_; }
 
-    fireSound_ = App::loadSound("sounds/shoot.wav");
-    dieSound_  = App::loadSound("sounds/explosion.wav");
-  }
+  int getLives() const { return lives_; }
 
   void reset() {
-    Graphic::reset();
-
+    pos_        = startPos_;
     lives_      = NUM_LIVES;
     fire_block_ = 0;
+  }
 
-    for (uint i = 0; i < NUM_BULLETS; ++i) {
-      delete bullets_[i];
-
-      bullets_[i] = nullptr;
-    }
+  // copy game state (not owner or resources) from other player
+  void copyState(const Player &player) {
+    pos_        = player.pos_;
+    lives_      = player.lives_;
+    fire_block_ = player.fire_block_;
   }
 
   void moveLeft () {
@@ -505,15 +1172,16 @@ class Player : public Graphic {
     if (pos_.x >= SCREEN_WIDTH - hs) pos_.x = SCREEN_WIDTH - hs - 1;
   }
 
-  void fire();
+  bool canFire() const { return fire_block_ == 0; }
 
-  void draw() {
-    Graphic::draw();
+  void fired();
 
-    for (uint i = 0; i < NUM_BULLETS; ++i) {
-      if (bullets_[i])
-        bullets_[i]->draw();
-    }
+  void update() {
+    if (fire_block_ > 0) --fire_block_;
+  }
+
+  void draw() {
+    App::drawImage(pos_.x - w_/2, pos_.y - h_/2, Assets::image(Assets::IMAGE_PLAYER));
 
     char str[64];
 
@@ -522,80 +1190,60 @@ class Player : public Graphic {
     App::drawLeftText(10, 10, str);
   }
 
-  void update();
+  Rect rect() const { return Rect(pos_.x - w_/2, pos_.y - h_/2, pos_.x + w_/2, pos_.y + h_/2); }
 
-  void checkHit(AlienBullet *bullet);
+  // hit by bullet covering rect over its step, confirmed against the bullet's
+  // mask (if any) at (x, y) moving by dy
+  bool checkHit(const Rect &rect, const Mask *mask=nullptr, int x=0, int y=0, int dy=0);
 
- private:
-  typedef std::vector<PlayerBullet *> BulletList;
+  uint64_t hash() const {
+    return hashCombine(hashMix(hashPair(pos_.x, pos_.y)), hashPair(lives_, fire_block_));
+  }
 
+ private:
   CSpaceInvaders *invaders_   { nullptr };
+  Point           startPos_;
+  Point           pos_;
+  int             w_          { 57 };
+  int             h_          { 35 };
   int             lives_      { 0 };
   int             d_          { 0 };
   int             fire_block_ { 0 };
-  BulletList      bullets_;
-  Sound          *fireSound_  { nullptr };
-  Sound          *dieSound_   { nullptr };
 };
 
 //---
 
-class Base : public Graphic {
+class Base {
+ public:
+  enum { NUM_CELLS = 8 }; // 2 rows of 4
+
  private:
+  enum { CELL_W = 22 };
+  enum { CELL_H = 29 };
+
   struct Cell {
-    ImageList images;
-    int       ind  { 0 };
-    bool      dead { false };
+    int  ind  { 0 }; // hits taken
+    bool dead { false };
 
     Cell() { }
 
-    void hit() { images.next(); ++ind; if (ind >= 4) dead = true; }
-
-    void reset() { images.reset(); ind = 0; dead = false; }
+    void hit() { ++ind; if (ind >= 4) dead = true; }
 
-    void addImage(Image *image) { images.addImage(image); }
+    void reset() { ind = 0; dead = false; }
   };
 
  public:
-  Base(const Point &pos) :
-   Graphic(pos, 87, 57) {
-     grid_[0][0].addImage(App::loadImage("images/base1a_1_1.png"));
-     grid_[0][1].addImage(App::loadImage("images/base1a_2_1.png"));
-     grid_[0][2].addImage(App::loadImage("images/base1a_3_1.png"));
-     grid_[0][3].addImage(App::loadImage("images/base1a_4_1.png"));
-     grid_[1][0].addImage(App::loadImage("images/base1a_1_2.png"));
-     grid_[1][1].addImage(App::loadImage("images/base1a_2_2.png"));
-     grid_[1][2].addImage(App::loadImage("images/base1a_3_2.png"));
-     grid_[1][3].addImage(App::loadImage("images/base1a_4_2.png"));
-
-     grid_[0][0].addImage(App::loadImage("images/base1a_1_1.png"));
-     grid_[0][1].addImage(App::loadImage("images/base1b_2_1.png"));
-     grid_[0][2].addImage(App::loadImage("images/base1b_3_1.png"));
-     grid_[0][3].addImage(App::loadImage("images/base1b_4_1.png"));
-     grid_[1][0].addImage(App::loadImage("images/base1b_1_2.png"));
-     grid_[1][1].addImage(App::loadImage("images/base1b_2_2.png"));
-     grid_[1][2].addImage(App::loadImage("images/base1b_3_2.png"));
-     grid_[1][3].addImage(App::loadImage("images/base1b_4_2.png"));
-
-     grid_[0][0].addImage(App::loadImage("images/base1c_1_1.png"));
-     grid_[0][1].addImage(App::loadImage("images/base1c_2_1.png"));
-     grid_[0][2].addImage(App::loadImage("images/base1c_3_1.png"));
-     grid_[0][3].addImage(App::loadImage("images/base1c_4_1.png"));
-     grid_[1][0].addImage(App::loadImage("images/base1c_1_2.png"));
-     grid_[1][1].addImage(App::loadImage("images/base1c_2_2.png"));
-     grid_[1][2].addImage(App::loadImage("images/base1c_3_2.png"));
-     grid_[1][3].addImage(App::loadImage("images/base1c_4_2.png"));
-
-     grid_[0][0].addImage(App::loadImage("images/base1d_1_1.png"));
-     grid_[0][1].addImage(App::loadImage("images/base1d_2_1.png"));
-     grid_[0][2].addImage(App::loadImage("images/base1d_3_1.png"));
-     grid_[0][3].addImage(App::loadImage("images/base1d_4_1.png"));
-     grid_[1][0].addImage(App::loadImage("images/base1d_1_2.png"));
-     grid_[1][1].addImage(App::loadImage("images/base1d_2_2.png"));
-     grid_[1][2].addImage(App::loadImage("images/base1d_3_2.png"));
-     grid_[1][3].addImage(App::loadImage("images/base1d_4_2.png"));
+  Base(const Point &pos=Point()) :
+   pos_(pos) {
   }
 
+  const Point &getPos() const { return pos_; }
+
+  void setPos(const Point &pos) { pos_ = pos; }
+
+  // number of hits taken by cell (4 when destroyed)
+  int getCellHits(int r, int c) const { return grid_[r][c].ind; }
+
   void reset() {
     for (int r = 0; r < 2; ++r)
       for (int c = 0; c < 4; ++c)
@@ -603,9 +1251,6 @@ class Base : public Graphic {
   }
 
   void draw() {
-    int dx = 22;
-    int dy = 29;
-
     int x = pos_.x - w_/2;
     int y = pos_.y + h_/2;
 
@@ -615,46 +1260,75 @@ class Base : public Graphic {
 
         if (cell.dead) continue;
 
-        cell.images.draw(Point(x + c*dx, y + r*dy));
+        App::drawImage(x + c*CELL_W, y + r*CELL_H, Assets::image(Assets::baseImage(cell.ind, r, c)));
       }
     }
   }
 
-  void checkHit(Bullet *bullet) {
-    int dx = 22;
-    int dy = 29;
+  uint64_t hash() const {
+    uint64_t h = hashMix(hashPair(pos_.x, pos_.y));
 
-    int y1 = pos_.y + h_/2;
-    int y2 = y1;
+    for (int r = 0; r < 2; ++r)
+      for (int c = 0; c < 4; ++c)
+        h = hashCombine(h, grid_[r][c].ind);
 
-    for (int r = 0; r < 2; ++r) {
-      y1 = y2;
-      y2 = y1 + dy;
+    return h;
+  }
 
-      int x1 = pos_.x - w_/2;
-      int x2 = x1;
+  // bounding box of all cells
+  Rect rect() const {
+    int x = pos_.x - w_/2;
+    int y = pos_.y + h_/2;
 
-      for (int c = 0; c < 4; ++c) {
-        x1 = x2;
-        x2 = x1 + dx;
+    return Rect(x, y, x + 4*CELL_W, y + 2*CELL_H);
+  }
 
-        Cell &cell = grid_[r][c];
+  // Hit live cells overlapping bullet rect (returns true if any hit). With the
+  // bullet's mask at (x, y) moving by dy a cell is only hit where the mask
+  // meets the solid pixels of the cell's current (damaged) image.
+  bool checkHit(const Rect &bulletRect, const Mask *mask=nullptr, int x=0, int y=0, int dy=0) {
+    Rect r = rect();
 
-        Rect rect(x1, y1, x2, y2);
+    if (! bulletRect.overlaps(r))
+      return false;
 
-        if (bullet->rect().overlaps(rect)) {
-          if (cell.dead) continue;
+    // cell c spans [x + c*CELL_W, x + (c + 1)*CELL_W] (inclusive, so adjacent
+    // cells share an edge) so the overlapped cells follow from the bullet extent
+    int c1 = std::max(ceilDiv (bulletRect.x1 - r.x1 - CELL_W, CELL_W), 0);
+    int c2 = std::min(floorDiv(bulletRect.x2 - r.x1         , CELL_W), 3);
+    int r1 = std::max(ceilDiv (bulletRect.y1 - r.y1 - CELL_H, CELL_H), 0);
+    int r2 = std::min(floorDiv(bulletRect.y2 - r.y1         , CELL_H), 1);
 
-          cell.hit();
+    bool hit = false;
 
-          bullet->setDead();
-        }
-      }
-    }
+    for (int row = r1; row <= r2; ++row) {
+      for (int c = c1; c <= c2; ++c) {
+        Cell &cell = grid_[row][c];
+
+        if (cell.dead) continue;
+
+        if (mask && ! mask->isEmpty()) {
+          const Mask &cellMask = Assets::mask(Assets::baseImage(cell.ind, row, c));
+
+          if (! cellMask.isEmpty() &&
+              mask->sweep(x, y, dy, cellMask, r.x1 + c*CELL_W, r.y1 + row*CELL_H) < 0)
+            continue;
+        }
+
+        cell.hit();
+
+        hit = true;
+      }
+    }
+
+    return hit;
   }
 
  private:
-  Cell grid_[2][4];
+  Point pos_;
+  int   w_ { 87 };
+  int   h_ { 57 };
+  Cell  grid_[2][4];
 };
 
 //---
@@ -671,6 +1345,10 @@ class Level {
     App::drawRightText(SCREEN_WIDTH - 10, 10, str);
   }
 
+  int value() const { return value_; }
+
+  void next() { ++value_; }
+
   void reset() { value_ = 1; }
 
  private:
@@ -680,30 +1358,159 @@ class Level {
 //---
 
 class CSpaceInvaders {
+ private:
+  enum { MYSTERY_DX         = -4 };
+  enum { EXPLODE_TICKS      = 4 };
+  enum { MAX_PARTICLES      = 8192 };
+
+ public:
+  // parts of the state hash (to narrow down where two games diverge)
+  enum HashSection {
+    HASH_ALIENS,
+    HASH_BULLETS,
+    HASH_BASES,
+    HASH_PLAYER,
+    HASH_SCORE,
+    HASH_RNG,
+    HASH_FORMATION,
+    NUM_HASH_SECTIONS
+  };
+
  public:
-  CSpaceInvaders()  {
+  // levels must outlive the game (nullptr for built-in default wave)
+  CSpaceInvaders(const CLevels *levels=nullptr) :
+   levels_(levels ? levels : &defaultLevels()) {
     init();
   }
 
+  // copy has its own arena with a snapshot of the game state
+  CSpaceInvaders(const CSpaceInvaders &invaders) :
+   levels_(invaders.levels_) {
+    init();
+
+    copyState(invaders);
+  }
+
+  // all entities are owned by (and destroyed with) the arena
+ ~CSpaceInvaders() { }
+
+  CSpaceInvaders &operator=(const CSpaceInvaders &invaders) {
+    if (&invaders == this) return *this;
+
+    // capacities depend on levels so reallocate if they differ
+    if (invaders.levels_ != levels_) {
+      bases_.clear();
+
+      arena_.clear();
+
+      levels_ = invaders.levels_;
+
+      init();
+    }
+
+    copyState(invaders);
+
+    return *this;
+  }
+
+  static const CLevels &defaultLevels() {
+    static CLevels levels;
+
+    return levels;
+  }
+
+  // allocate everything needed by the largest wave once
   void init() {
-    player_ = new Player(this, Point(400, 950));
+    bases_.reserve(levels_->maxBases());
 
-    score_ = new Score(Point(SCREEN_WIDTH/2, 10));
+    player_ = arena_.create<Player>(this, Point(400, 950));
 
-    alienMgr_ = new AlienManager(this);
+    score_ = arena_.create<Score>(Point(SCREEN_WIDTH/2, 10));
 
-    mysteryAlien_ = new MysteryAlien(this);
+    for (int i = 0; i < levels_->maxBases(); ++i)
+      addBase(Point());
 
-    for (int i = 0; i < 4; ++i)
-      addBase(Point(98*(2*i + 1), 840));
+    aliens_       .init(arena_, levels_->maxAliens());
+    playerBullets_.init(arena_, levels_->maxPlayerBullets());
+    alienBullets_ .init(arena_, levels_->maxAlienBullets());
+    mystery_      .init(arena_, 1);
+    particles_    .init(arena_, MAX_PARTICLES);
 
-    for (int y = 0; y < 5; ++y) {
-      for (int x = 0; x < 11; ++x) {
-        addAlien(x, y, 34*(2*x + 1));
-      }
+    alienBulletGrid_.init(arena_, levels_->maxAlienBullets());
+
+    for (int i = 0; i < NUM_ALIEN_TYPES; ++i) {
+      alienSprites_[i].addImage(alienTypes[i].image1);
+      alienSprites_[i].addImage(alienTypes[i].image2);
     }
+
+    playerBulletSprite_.addImage(Assets::IMAGE_PLAYER_BULLET);
+    alienBulletSprite_ .addImage(Assets::IMAGE_ALIEN_BULLET);
+    mysterySprite_     .addImage(Assets::IMAGE_MYSTERY);
+
+    applyWave();
+  }
+
+  // copy all game state (no allocation) from game using same levels
+  void copyState(const CSpaceInvaders &invaders) {
+    assert(invaders.levels_ == levels_);
+
+    wave_ = invaders.wave_;
+
+    player_->copyState(*invaders.player_);
+
+    level_  = invaders.level_;
+    *score_ = *invaders.score_;
+
+    for (size_t i = 0; i < bases_.size(); ++i)
+      *bases_[i] = *invaders.bases_[i];
+
+    numBases_  = invaders.numBases_;
+    basesRect_ = invaders.basesRect_;
+    basesHash_ = invaders.basesHash_;
+    alienHash_ = invaders.alienHash_;
+
+    aliens_       .copy(invaders.aliens_);
+    playerBullets_.copy(invaders.playerBullets_);
+    alienBullets_ .copy(invaders.alienBullets_);
+    mystery_      .copy(invaders.mystery_);
+    particles_    .copy(invaders.particles_);
+
+    input_    = invaders.input_;
+    rng_      = invaders.rng_;
+    fxRng_    = invaders.fxRng_;
+    tick_     = invaders.tick_;
+    paused_   = invaders.paused_;
+    gameOver_ = invaders.gameOver_;
+  }
+
+  const CLevels *levels() const { return levels_; }
+
+  const WaveDef &wave() const { return *wave_; }
+
+  int getLevel() const { return level_.value(); }
+
+  CArena &arena() { return arena_; }
+
+  // total bytes owned by this game instance
+  size_t memoryUsage() const {
+    return sizeof(*this) + arena_.size() + bases_.capacity()*sizeof(Base *);
   }
 
+  // upper bound on draw list ops for one frame (largest wave with all
+  // particles live) so render buffers can be sized up front
+  int maxDrawOps() const {
+    return 4 + // level, score, lives and game over text
+           1 + // player
+           levels_->maxPlayerBullets() +
+           levels_->maxAliens() +
+           levels_->maxBases()*Base::NUM_CELLS +
+           levels_->maxAlienBullets() +
+           mystery_.capacity() +
+           particles_.capacity();
+  }
+
+  //---
+
   void draw() {
     level_.draw();
 
@@ -711,59 +1518,119 @@ class CSpaceInvaders {
 
     player_->draw();
 
-    for (auto &alien : aliens_)
-      alien->draw();
+    drawSystem(playerBullets_, &playerBulletSprite_);
 
-    for (auto &base : bases_)
-      base->draw();
+    drawAliens();
+
+    for (int i = 0; i < numBases_; ++i)
+      bases_[i]->draw();
 
-    alienMgr_->draw();
+    drawSystem(alienBullets_, &alienBulletSprite_);
 
-    mysteryAlien_->draw();
+    drawSystem(mystery_, &mysterySprite_);
+
+    drawParticles();
 
     if (gameOver_)
       App::drawCenteredText(SCREEN_WIDTH/2, SCREEN_HEIGHT/2, "GAME OVER");
   }
 
   void update() {
-    if (paused_ || gameOver_) return;
+    if (paused_) return;
+
+    // explosions play out after game over
+    particles_.update();
+
+    if (gameOver_) return;
+
+    ++tick_;
+
+    if      (input_.left ) player_->moveLeft ();
+    else if (input_.right) player_->moveRight();
+
+    if (input_.fire) shipFire();
 
     player_->update();
 
-    alienMgr_->preUpdate();
+    updatePlayerBullets();
+
+    updateAliens();
 
-    for (auto &alien : aliens_)
-      alien->update();
+    updateAlienBullets();
 
-    alienMgr_->postUpdate();
+    updateMystery();
 
-    alienMgr_->update();
+    playerBullets_.compact();
+    alienBullets_ .compact();
+    mystery_      .compact();
+  }
 
-    mysteryAlien_->update();
+  // Advance actionRepeat ticks with the current input and return the score
+  // gained over them (stops early when paused or at game over). Callers
+  // draw or observe only the final tick.
+  int step() {
+    int score = getScore();
 
-    if (mysteryAlien_->isDead()) {
-      if (Util::random() < 0.01) {
-        mysteryAlien_->reset();
+    for (int i = 0; i < actionRepeat_ && ! paused_ && ! gameOver_; ++i)
+      update();
 
-        mysteryAlien_->setDead(false);
-      }
+    return getScore() - score;
+  }
+
+  //---
+
+  // switch to wave for current level (reuses allocated entities)
+  void applyWave() {
+    wave_ = &levels_->wave(level_.value());
+
+    numBases_ = std::min(wave_->numBases, int(bases_.size()));
+
+    for (int i = 0; i < numBases_; ++i) {
+      bases_[i]->setPos(Point(wave_->baseX + i*wave_->baseDX, wave_->baseY));
+
+      Rect r = bases_[i]->rect();
+
+      if (i == 0)
+        basesRect_ = r;
+      else
+        basesRect_ = Rect(std::min(basesRect_.x1, r.x1), std::min(basesRect_.y1, r.y1),
+                          std::max(basesRect_.x2, r.x2), std::max(basesRect_.y2, r.y2));
     }
+
+    basesHash_ = computeBasesHash();
+
+    addAliens();
   }
 
-  void addAlien(int x_ind, int y_ind, int x) {
-    int y = alienMgr_->getRowY(y_ind);
+  // fill formation for current wave
+  void addAliens() {
+    aliens_.reset(*wave_);
 
-    Point pos(x, y);
+    alienHash_ = 0;
 
-    if      (y_ind == 0              ) aliens_.push_back(new Alien1(alienMgr_, x_ind, y_ind, pos));
-    else if (y_ind == 1 || y_ind == 2) aliens_.push_back(new Alien2(alienMgr_, x_ind, y_ind, pos));
-    else if (y_ind == 3 || y_ind == 4) aliens_.push_back(new Alien3(alienMgr_, x_ind, y_ind, pos));
+    aliens_.forEachPresent([&](int i) { alienHash_ += alienKey(i); });
   }
 
   void addBase(const Point &pos) {
-    bases_.push_back(new Base(pos));
+    bases_.push_back(arena_.create<Base>(pos));
   }
 
+  //---
+
+  int getScore() const { return score_->value(); }
+
+  int getLives() const { return player_->getLives(); }
+
+  int getNumAliens() const { return aliens_.size(); }
+
+  bool isPaused  () const { return paused_; }
+  bool isGameOver() const { return gameOver_; }
+
+  const Input &input() const { return input_; }
+
+  // held input state, applied once per update
+  void setInput(const Input &input) { input_ = input; }
+
   void moveShipLeft() {
     if (paused_ || gameOver_) return;
 
@@ -779,31 +1646,66 @@ class CSpaceInvaders {
   void shipFire() {
     if (paused_ || gameOver_) return;
 
-    player_->fire();
-  }
+    if (! player_->canFire()) return;
 
-  void checkAlienHit(PlayerBullet *bullet) {
-    for (auto &alien : aliens_)
-      alien->checkHit(bullet);
+    if (playerBullets_.size() >= wave_->playerBullets) return;
 
-    alienMgr_->checkHit(bullet);
+    const Point &pos = player_->getPos();
 
-    mysteryAlien_->checkHit(bullet);
-  }
+    int i = playerBullets_.add(pos.x, pos.y - player_->getHeight()/2, 4, 26);
 
-  void checkPlayerHit(AlienBullet *bullet) {
-    player_->checkHit(bullet);
-  }
+    if (i < 0) return;
 
-  void checkBaseHit(Bullet *bullet) {
-    for (auto &base : bases_)
-      base->checkHit(bullet);
+    playerBullets_.dy[i] = -wave_->playerBulletSpeed;
+
+    player_->fired();
   }
 
   void addScore(int score) {
     score_->add(score);
   }
 
+  // sounds off for simulation only copies (e.g. search rollouts)
+  bool isSoundEnabled() const { return soundEnabled_; }
+
+  void setSoundEnabled(bool b) { soundEnabled_ = b; }
+
+  void playSound(Sound *sound) {
+    if (soundEnabled_)
+      App::playSound(sound);
+  }
+
+  // explosion particles off for headless games (visual only, no effect on play)
+  bool isEffectsEnabled() const { return effectsEnabled_; }
+
+  void setEffectsEnabled(bool b) { effectsEnabled_ = b; if (! b) particles_.clear(); }
+
+  // burst of num particles at (x, y) with speeds up to speed (pixels per tick).
+  // Uses its own random numbers so enabling effects does not change play.
+  void addExplosion(int x, int y, int num, int color, float speed) {
+    if (! effectsEnabled_) return;
+
+    for (int i = 0; i < num; ++i) {
+      float a = float(2*M_PI*fxRng_.random());
+      float s = speed*float(0.25 + 0.75*fxRng_.random());
+
+      int life = 12 + int(20*fxRng_.random());
+
+      if (particles_.add(x, y, s*std::cos(a), s*std::sin(a), life, color) < 0)
+        break;
+    }
+  }
+
+  // grid broadphase for bullet hits (off only to benchmark the linear scan)
+  bool isBroadphaseEnabled() const { return broadphase_; }
+
+  void setBroadphaseEnabled(bool b) { broadphase_ = b; }
+
+  // ticks advanced by each step (action repeat / frame skip)
+  int actionRepeat() const { return actionRepeat_; }
+
+  void setActionRepeat(int n) { actionRepeat_ = std::max(n, 1); }
+
   void pause() {
     paused_ = ! paused_;
   }
@@ -816,17 +1718,23 @@ class CSpaceInvaders {
     paused_   = false;
     gameOver_ = false;
 
-    for (auto &alien : aliens_)
-      alien->reset();
+    level_.next();
+
+    applyWave();
 
-    alienMgr_->reset();
+    alienBullets_.clear();
 
-    mysteryAlien_->reset();
+    mystery_.clear();
   }
 
   void restart() {
     if (! paused_ && ! gameOver_) return;
 
+    reset();
+  }
+
+  // restart new game unconditionally (optionally reseeding random numbers)
+  void reset() {
     paused_   = false;
     gameOver_ = false;
 
@@ -836,265 +1744,595 @@ class CSpaceInvaders {
 
     player_->reset();
 
-    for (auto &alien : aliens_)
-      alien->reset();
+    playerBullets_.clear();
 
     for (auto &base : bases_)
       base->reset();
 
-    alienMgr_->reset();
+    applyWave();
+
+    alienBullets_.clear();
+
+    mystery_.clear();
+
+    particles_.clear();
   }
 
- private:
-  typedef std::vector<Alien *> AlienList;
-  typedef std::vector<Base *>  BaseList;
-
-  Player       *player_       { nullptr };
-  Level         level_;
-  Score        *score_        { nullptr };
-  AlienManager *alienMgr_     { nullptr };
-  AlienList     aliens_;
-  MysteryAlien *mysteryAlien_ { nullptr };
-  BaseList      bases_;
-  bool          paused_       { false };
-  bool          gameOver_     { false };
-};
+  void reset(uint64_t seed) {
+    rng_  .setSeed(seed);
+    fxRng_.setSeed(~seed);
 
-//--------------
+    tick_ = 0;
 
-void
-Player::
-fire()
-{
-  if (fire_block_ > 0) return;
+    input_ = Input();
+
+    // formation direction carries over restarts, so start as a new game does
+    aliens_.setDir(1);
+
+    reset();
+  }
 
-  for (uint i = 0; i < NUM_BULLETS; ++i) {
-    if (bullets_[i]) continue;
+  //--- state access (for agents and tools)
 
-    bullets_[i] = new PlayerBullet(this, Point(pos_.x, pos_.y - h_/2));
+  long getTick() const { return tick_; }
 
-    fire_block_ = 8;
+  Random &rng() { return rng_; }
 
-    App::playSound(fireSound_);
+  const Point &getPlayerPos() const { return player_->getPos(); }
 
-    return;
+  int getNumBases() const { return numBases_; }
+
+  const Base &getBase(int i) const { return *bases_[i]; }
+
+  const AlienFormation &getAliens() const { return aliens_; }
+
+  const EntityStore &getPlayerBullets() const { return playerBullets_; }
+  const EntityStore &getAlienBullets () const { return alienBullets_; }
+  const EntityStore &getMystery      () const { return mystery_; }
+
+  //--- state hash
+
+  // Hash of the complete simulation state (aliens, bullets, bases, player,
+  // score, level, tick, random number state and formation), cheap enough to
+  // take every tick. Aliens are hashed as a sum of per alien keys relative to
+  // the formation origin, kept up to date as aliens are added, hit and
+  // removed, so formation moves do not touch it. Base cells are rehashed
+  // only when hit. Bullets (few and all moving) are hashed in full.
+  //
+  // Explosion particles, their random numbers, input and settings are not
+  // included (visual only or applied by the next tick).
+  uint64_t stateHash() const {
+    uint64_t hashes[NUM_HASH_SECTIONS];
+
+    stateHashes(hashes);
+
+    uint64_t h = 0;
+
+    for (int i = 0; i < NUM_HASH_SECTIONS; ++i)
+      h = hashCombine(h, hashes[i]);
+
+    return h;
   }
-}
 
-void
-Player::
-update()
-{
-  if (fire_block_ > 0) --fire_block_;
+  void stateHashes(uint64_t hashes[NUM_HASH_SECTIONS]) const {
+    uint64_t bullets = hashStore(playerBullets_, 1);
+
+    bullets = hashCombine(bullets, hashStore(alienBullets_, 2));
+    bullets = hashCombine(bullets, hashStore(mystery_     , 3));
+
+    uint64_t score = hashMix(hashPair(score_->value(), level_.value()));
+
+    score = hashCombine(score, uint64_t(tick_));
+    score = hashCombine(score, hashPair(paused_, gameOver_));
+
+    hashes[HASH_ALIENS   ] = hashCombine(alienHash_, aliens_.size());
+    hashes[HASH_BULLETS  ] = bullets;
+    hashes[HASH_BASES    ] = basesHash_;
+    hashes[HASH_PLAYER   ] = player_->hash();
+    hashes[HASH_SCORE    ] = score;
+    hashes[HASH_RNG      ] = hashMix(rng_.state());
+    hashes[HASH_FORMATION] = aliens_.hash();
+  }
 
-  for (uint i = 0; i < NUM_BULLETS; ++i) {
-    if (! bullets_[i]) continue;
+  static const char *hashSectionName(int i) {
+    static const char *names[NUM_HASH_SECTIONS] = {
+      "aliens", "bullets", "bases", "player", "score", "rng", "formation"
+    };
 
-    bullets_[i]->update();
+    return (i >= 0 && i < NUM_HASH_SECTIONS ? names[i] : "");
+  }
+
+  // recompute incrementally kept hashes from scratch and compare (debug check)
+  bool checkStateHash() const {
+    uint64_t alienHash = 0;
+
+    aliens_.forEachPresent([&](int i) { alienHash += alienKey(i); });
+
+    return (alienHash == alienHash_ && computeBasesHash() == basesHash_);
+  }
+
+ private:
+  // hash of live or exploding alien (position relative to formation origin)
+  uint64_t alienKey(int i) const {
+    uint64_t h = hashMix(hashPair(aliens_.offsetX(i), aliens_.offsetY(i)));
+
+    return hashCombine(h, hashPair(aliens_.type(i), aliens_.explode(i)));
+  }
 
-    if (! bullets_[i]->isDead())
-      invaders_->checkAlienHit(bullets_[i]);
+  uint64_t computeBasesHash() const {
+    uint64_t h = hashMix(numBases_);
 
-    if (! bullets_[i]->isDead())
-      invaders_->checkBaseHit(bullets_[i]);
+    for (int i = 0; i < numBases_; ++i)
+      h = hashCombine(h, bases_[i]->hash());
 
-    if (bullets_[i]->isDead()) {
-      delete bullets_[i];
+    return h;
+  }
+
+  // ordered hash of all entities in store
+  static uint64_t hashStore(const EntityStore &store, uint64_t seed) {
+    uint64_t h = hashMix(hashPair(int(seed), store.size()));
 
-      bullets_[i] = nullptr;
+    for (int i = 0; i < store.size(); ++i) {
+      h = hashCombine(h, hashPair(store.x [i], store.y [i]));
+      h = hashCombine(h, hashPair(store.dx[i], store.dy[i]));
+      h = hashCombine(h, hashPair(store.type[i], store.explode[i] | (store.dead[i] << 8)));
     }
+
+    return h;
   }
-}
 
-void
-Player::
-checkHit(AlienBullet *bullet)
-{
-  if (bullet->isDead()) return;
+ private:
+  //--- systems
 
-  if (isDead()) return;
+  // move all non-exploding entities by their velocity
+  void moveSystem(EntityStore &store) {
+    for (int i = 0; i < store.size(); ++i) {
+      if (store.dead[i] || store.explode[i]) continue;
 
-  if (bullet->rect().overlaps(rect())) {
-    --lives_;
+      store.x[i] += store.dx[i];
+      store.y[i] += store.dy[i];
+    }
+  }
 
-    App::playSound(dieSound_);
+  // count down explosions and kill entity when done
+  void explodeSystem(EntityStore &store) {
+    for (int i = 0; i < store.size(); ++i) {
+      if (store.explode[i] == 0) continue;
 
-    bullet->setDead();
+      if (--store.explode[i] == 0)
+        store.dead[i] = 1;
+    }
+  }
 
-    if (lives_ <= 0)
-      invaders_->setGameOver();
+  // kill entities whose centre leaves [ymin, ymax)
+  void boundsSystem(EntityStore &store, int ymin, int ymax) {
+    for (int i = 0; i < store.size(); ++i) {
+      if (store.y[i] < ymin || store.y[i] >= ymax)
+        store.dead[i] = 1;
+    }
   }
-}
 
-//--------------
+  // draw entities with their own animation frame
+  void drawSystem(const EntityStore &store, const Sprite *sprites) {
+    for (int i = 0; i < store.size(); ++i) {
+      if (store.dead[i]) continue;
 
-void
-AlienManager::
-preUpdate()
-{
-  needsIncRow_ = false;
+      // explosion is drawn by particles
+      if (store.explode[i]) continue;
 
-  numAlive_ = 0;
-}
+      const Sprite &sprite = sprites[store.type[i]];
 
-void
-AlienManager::
-postUpdate()
-{
-  if (needsIncRow_) {
-    for (int y = 0; y < 5; ++y)
-      row_y_[y] += w_/2;
+      if (sprite.num == 0) continue;
 
-    dir_ = -dir_;
+      App::drawImage(store.x[i] - store.w[i]/2, store.y[i] - store.h[i]/2,
+                     sprite.images[store.frame[i] % sprite.num]);
+    }
+  }
 
-    ++speed_;
+  // draw live aliens with the formation's animation frame
+  void drawAliens() {
+    aliens_.forEachAlive([&](int i) {
+      const Sprite &sprite = alienSprites_[aliens_.type(i)];
 
-    needsIncRow_ = false;
+      if (sprite.num == 0) return;
+
+      App::drawImage(aliens_.x(i) - aliens_.w(i)/2, aliens_.y(i) - aliens_.h(i)/2,
+                     sprite.images[aliens_.frame() % sprite.num]);
+    });
   }
 
-  if (numAlive_ == 0)
-    invaders_->nextLevel();
-}
+  void drawParticles() {
+    const ParticleStore &p = particles_;
 
-void
-AlienManager::
-update()
-{
-  for (uint i = 0; i < NUM_BULLETS; ++i) {
-    if (! bullets_[i]) continue;
+    for (int i = 0; i < p.size(); ++i) {
+      // shrink as particle expires
+      int s = (p.life[i] > 8 ? 4 : 2);
+
+      App::fillRect(int(p.x[i]) - s/2, int(p.y[i]) - s/2, s, s, particleColors[p.color[i]]);
+    }
+  }
 
-    bullets_[i]->update();
+  //--- collision
 
-    if (! bullets_[i]->isDead())
-      invaders_->checkPlayerHit(bullets_[i]);
+  // Bullet collisions are swept over the tick's step rather than tested at
+  // the end position only, so fast bullets (or large steps) cannot pass
+  // through a target between ticks. Bullets move vertically and targets are
+  // static while bullets move, apart from alien bullets which are still to
+  // move this tick, so a vertical sweep against each target is exact.
+  //
+  // Boxes only find candidates: a hit is confirmed by the collision masks of
+  // the images as drawn (pixel accurate), at the first whole pixel offset of
+  // the step where they overlap.
 
-    if (! bullets_[i]->isDead())
-      invaders_->checkBaseHit(bullets_[i]);
+  // mask of sprite frame (empty if sprite has no images)
+  static const Mask &spriteMask(const Sprite &sprite, int frame) {
+    static Mask empty;
 
-    if (bullets_[i]->isDead()) {
-      delete bullets_[i];
+    if (sprite.num == 0) return empty;
 
-      bullets_[i] = nullptr;
+    return *sprite.masks[frame % sprite.num];
+  }
+
+  // mask of entity's current image (as drawSystem draws it)
+  static const Mask &entityMask(const EntityStore &store, const Sprite *sprites, int i) {
+    return spriteMask(sprites[store.type[i]], store.frame[i]);
+  }
+
+  // fraction (0-1) of a vertical step of dy of rect (with mask at its top
+  // left) at which it first hits target rect (with its mask at its top left),
+  // or -1 if it does not
+  static double sweepHit(const Rect &rect, const Mask &mask, int dy,
+                         const Rect &target, const Mask &targetMask) {
+    double t = rect.sweepY(dy, target);
+
+    if (t < 0.0 || mask.isEmpty() || targetMask.isEmpty())
+      return t;
+
+    int o = mask.sweep(rect.x1, rect.y1, dy, targetMask, target.x1, target.y1);
+
+    if (o < 0) return -1.0;
+
+    return (dy != 0 ? double(o)/std::abs(dy) : 0.0);
+  }
+
+  // alive entity in store first hit by rect (with mask at its top left)
+  // moving by a vertical step of dy (relative to each entity's own pending
+  // dy), or -1. t is set to the fraction of the step at the hit. Candidates
+  // come from the store's grid when given, otherwise all entities are tested.
+  int sweepTest(const EntityStore &store, const Sprite *sprites,
+                const SpatialGrid *grid, const Rect &rect, const Mask &mask,
+                int dy, double &t) const {
+    int hit = -1;
+
+    auto test = [&](int i) {
+      if (! store.isAlive(i)) return;
+
+      double ti = sweepHit(rect, mask, dy - store.dy[i], store.rect(i),
+                           entityMask(store, sprites, i));
+
+      // lowest index on ties so grid and linear scan agree
+      if (ti >= 0.0 && (hit < 0 || ti < t || (ti == t && i < hit))) {
+        hit = i;
+        t   = ti;
+      }
+    };
+
+    if (grid)
+      grid->query(rect.sweptY(-dy), test);
+    else {
+      for (int i = 0; i < store.size(); ++i)
+        test(i);
     }
+
+    return hit;
   }
-}
 
-void
-AlienManager::
-fire(Alien *alien)
-{
-  const Point &pos = alien->getPos();
+  // as sweepTest for the live aliens (candidates mapped into the formation
+  // grid, or all tested when the broadphase is off)
+  int alienSweepTest(const Rect &rect, const Mask &mask, int dy, double &t) const {
+    int hit = -1;
+
+    auto test = [&](int i) {
+      const Mask &alienMask = spriteMask(alienSprites_[aliens_.type(i)], aliens_.frame());
 
-  for (uint i = 0; i < NUM_BULLETS; ++i) {
-    if (bullets_[i]) continue;
+      double ti = sweepHit(rect, mask, dy, aliens_.rect(i), alienMask);
 
-    bullets_[i] = new AlienBullet(alien, Point(pos.x, pos.y + 24));
+      // cells are visited in index order so the first wins ties
+      if (ti >= 0.0 && (hit < 0 || ti < t)) {
+        hit = i;
+        t   = ti;
+      }
+    };
+
+    if (broadphase_)
+      aliens_.query(rect.sweptY(-dy), test);
+    else
+      aliens_.forEachAlive(test);
 
-    return;
+    return hit;
   }
-}
 
-void
-AlienManager::
-checkHit(PlayerBullet *bullet)
-{
-  if (bullet->isDead()) return;
+  // hit bases with bullet i of store over its step this tick
+  bool checkBaseHit(const EntityStore &store, const Sprite &sprite, int i) {
+    Rect rect = store.rect(i).sweptY(store.dy[i]);
 
-  for (uint i = 0; i < NUM_BULLETS; ++i) {
-    if (! bullets_[i]) continue;
+    // most bullets are nowhere near the bases
+    if (numBases_ == 0 || ! rect.overlaps(basesRect_))
+      return false;
 
-    if (bullet->rect().overlaps(bullets_[i]->rect())) {
-      delete bullets_[i];
+    Rect start = startRect(store, i);
 
-      bullets_[i] = nullptr;
+    const Mask &mask = entityMask(store, &sprite, i);
 
-      bullet->setDead();
+    bool hit = false;
 
-      return;
+    for (int ib = 0; ib < numBases_; ++ib) {
+      if (bases_[ib]->checkHit(rect, &mask, start.x1, start.y1, store.dy[i]))
+        hit = true;
     }
+
+    if (hit) {
+      basesHash_ = computeBasesHash();
+
+      addExplosion((rect.x1 + rect.x2)/2, (rect.y1 + rect.y2)/2, 8, PARTICLE_GREEN, 2.0f);
+    }
+
+    return hit;
   }
-}
 
-//--------------
+  // rect of entity at start of its step this tick
+  static Rect startRect(const EntityStore &store, int i) {
+    Rect rect = store.rect(i);
 
-void
-Alien::
-checkHit(PlayerBullet *bullet)
-{
-  if (bullet->isDead()) return;
+    rect.y1 -= store.dy[i];
+    rect.y2 -= store.dy[i];
+
+    return rect;
+  }
 
-  if (isDead() || isExploding()) return;
+  void checkAlienHit(int ib) {
+    Rect rect = startRect(playerBullets_, ib);
+    int  dy   = playerBullets_.dy[ib];
 
-  if (bullet->rect().overlaps(rect())) {
-    setExploding();
+    // earliest of alien, alien bullet and mystery hit
+    double ta = 0.0, tb = 0.0, tm = 0.0;
 
-    mgr_->getInvaders()->addScore(getScore());
+    const SpatialGrid *alienBulletGrid = (broadphase_ ? &alienBulletGrid_ : nullptr);
 
-    App::playSound(dieSound_);
+    const Mask &mask = entityMask(playerBullets_, &playerBulletSprite_, ib);
 
-    bullet->setDead();
+    int ia = alienSweepTest(rect, mask, dy, ta);
+
+    int ab = sweepTest(alienBullets_, &alienBulletSprite_, alienBulletGrid, rect, mask, dy, tb);
+    int im = sweepTest(mystery_     , &mysterySprite_    , nullptr        , rect, mask, dy, tm);
+
+    if (ia >= 0 && (ab < 0 || ta <= tb) && (im < 0 || ta <= tm)) {
+      alienHash_ -= alienKey(ia);
+
+      aliens_.kill(ia, EXPLODE_TICKS);
+
+      alienHash_ += alienKey(ia);
+
+      addExplosion(aliens_.x(ia), aliens_.y(ia), 24, PARTICLE_WHITE, 3.0f);
+
+      addScore(alienTypes[aliens_.type(ia)].score);
+
+      playSound(Assets::sound(Assets::SOUND_INVADER_KILLED));
+
+      playerBullets_.dead[ib] = 1;
+    }
+    else if (ab >= 0 && (im < 0 || tb <= tm)) {
+      alienBullets_.dead[ab] = 1;
+
+      playerBullets_.dead[ib] = 1;
+    }
+    else if (im >= 0) {
+      mystery_.explode[im] = EXPLODE_TICKS;
+
+      addExplosion(mystery_.x[im], mystery_.y[im], 32, PARTICLE_RED, 3.0f);
+
+      addScore(mysteryScore());
+
+      playSound(Assets::sound(Assets::SOUND_INVADER_KILLED));
+
+      playerBullets_.dead[ib] = 1;
+    }
   }
-}
 
-void
-Alien::
-update()
-{
-  ExplodeGraphic::update();
+  int mysteryScore() {
+    double r = rng_.random();
 
-  if (isDead()) return;
+    if      (r < 0.50) return 100;
+    else if (r < 0.80) return 200;
+    else if (r < 0.95) return 300;
+    else               return 400;
+  }
 
-  pos_.x += mgr_->getSpeed()*mgr_->getDir();
+  //--- per entity type updates
 
-  if (isExploding()) return;
+  void updatePlayerBullets() {
+    moveSystem(playerBullets_);
 
-  int hs = mgr_->getWidth()/2;
+    // targets do not move while player bullets are tested (aliens need no
+    // build, their grid is the formation)
+    if (broadphase_ && ! playerBullets_.isEmpty())
+      alienBulletGrid_.build(alienBullets_);
 
-  if (pos_.x >= SCREEN_WIDTH - hs) {
-    //pos_.x = SCREEN_WIDTH - hs - 1;
+    // hits before bounds so a step leaving the screen can still hit
+    for (int i = 0; i < playerBullets_.size(); ++i) {
+      if (playerBullets_.dead[i]) continue;
+
+      checkAlienHit(i);
+
+      if (playerBullets_.dead[i]) continue;
+
+      if (checkBaseHit(playerBullets_, playerBulletSprite_, i))
+        playerBullets_.dead[i] = 1;
+    }
 
-    mgr_->setNeedsIncRow();
+    boundsSystem(playerBullets_, 10, SCREEN_HEIGHT);
   }
-  else if (pos_.x < hs) {
-    //pos_.x = hs;
 
-    mgr_->setNeedsIncRow();
+  void updateAliens() {
+    // count down explosions keeping alien hash up to date
+    aliens_.forEachExploding([&](int i) {
+      alienHash_ -= alienKey(i);
+
+      if (aliens_.explodeTick(i))
+        alienHash_ += alienKey(i);
+    });
+
+    // formation moves as a whole (exploding aliens with it)
+    aliens_.move(aliens_.getSpeed()*aliens_.dir());
+
+    aliens_.animate();
+
+    if (aliens_.numAlive() > 0) {
+      int hs = AlienFormation::EDGE_W/2;
+
+      bool needsIncRow = (aliens_.rightX() >= SCREEN_WIDTH - hs || aliens_.leftX() < hs);
+
+      // each live alien may fire (one random number each, in index order)
+      aliens_.forEachAlive([&](int i) {
+        if (rng_.random() < wave_->fireProb)
+          fireAlienBullet(i);
+      });
+
+      if (aliens_.bottomY() > 900)
+        setGameOver();
+
+      if (needsIncRow)
+        aliens_.dropRow(wave_->drop, wave_->speedInc);
+    }
+
+    if (aliens_.numAlive() == 0)
+      nextLevel();
   }
 
-  --imageCount_;
+  void fireAlienBullet(int ia) {
+    if (alienBullets_.size() >= wave_->alienBullets) return;
 
-  if (imageCount_ <= 0) {
-    nextImage();
+    int i = alienBullets_.add(aliens_.x(ia), aliens_.y(ia) + 24, 9, 26);
 
-    imageCount_ = 4;
+    if (i >= 0)
+      alienBullets_.dy[i] = wave_->alienBulletSpeed;
   }
 
-  if (Util::random() < 0.01)
-    mgr_->fire(this);
+  void updateAlienBullets() {
+    moveSystem(alienBullets_);
 
-  mgr_->incAlive();
+    for (int i = 0; i < alienBullets_.size(); ++i) {
+      if (alienBullets_.dead[i]) continue;
 
-  if (mgr_->getRowY(row_) > 900)
-    mgr_->getInvaders()->setGameOver();
-}
+      // player and bases are static so sweep is the step's covered area
+      Rect rect  = alienBullets_.rect(i).sweptY(alienBullets_.dy[i]);
+      Rect start = startRect(alienBullets_, i);
+
+      const Mask &mask = entityMask(alienBullets_, &alienBulletSprite_, i);
+
+      if (! gameOver_ && player_->checkHit(rect, &mask, start.x1, start.y1, alienBullets_.dy[i])) {
+        alienBullets_.dead[i] = 1;
+        continue;
+      }
+
+      if (checkBaseHit(alienBullets_, alienBulletSprite_, i))
+        alienBullets_.dead[i] = 1;
+    }
+
+    boundsSystem(alienBullets_, 0, SCREEN_HEIGHT);
+  }
+
+  void updateMystery() {
+    explodeSystem(mystery_);
+
+    moveSystem(mystery_);
+
+    for (int i = 0; i < mystery_.size(); ++i) {
+      if (mystery_.x[i] < 0)
+        mystery_.dead[i] = 1;
+    }
+
+    if (mystery_.isEmpty()) {
+      if (rng_.random() < wave_->mysteryProb) {
+        int i = mystery_.add(SCREEN_WIDTH + 71/2, 60, 71, 31);
+
+        mystery_.dx[i] = MYSTERY_DX;
+      }
+    }
+  }
+
+ private:
+  typedef std::vector<Base *> BaseList;
+
+  CArena         arena_;
+  const CLevels *levels_         { nullptr };
+  const WaveDef *wave_           { nullptr };
+  Player        *player_         { nullptr };
+  Level          level_;
+  Score         *score_          { nullptr };
+  BaseList       bases_;
+  int            numBases_       { 0 };
+  Rect           basesRect_;
+  uint64_t       basesHash_      { 0 };
+  uint64_t       alienHash_      { 0 }; // sum of alienKey of live and exploding aliens
+  AlienFormation aliens_;
+  EntityStore    playerBullets_;
+  EntityStore    alienBullets_;
+  EntityStore    mystery_;
+  ParticleStore  particles_;
+  SpatialGrid    alienBulletGrid_;
+  Sprite         alienSprites_[NUM_ALIEN_TYPES];
+  Sprite         playerBulletSprite_;
+  Sprite         alienBulletSprite_;
+  Sprite         mysterySprite_;
+  Input          input_;
+  Random         rng_;
+  Random         fxRng_;
+  long           tick_           { 0 };
+  bool           paused_         { false };
+  bool           gameOver_       { false };
+  bool           soundEnabled_   { true };
+  bool           effectsEnabled_ { true };
+  int            actionRepeat_   { 1 };
+  bool           broadphase_     { true };
+};
 
 //--------------
 
-void
-MysteryAlien::
-checkHit(PlayerBullet *bullet)
+inline void
+Player::
+fired()
 {
-  if (bullet->isDead()) return;
-
-  if (isDead() || isExploding()) return;
+  fire_block_ = invaders_->wave().fireDelay;
 
-  if (bullet->rect().overlaps(rect())) {
-    setExploding();
+  invaders_->playSound(Assets::sound(Assets::SOUND_SHOOT));
+}
 
-    invaders_->addScore(getScore());
+inline bool
+Player::
+checkHit(const Rect &rect, const Mask *mask, int x, int y, int dy)
+{
+  if (! rect.overlaps(this->rect()))
+    return false;
 
-    App::playSound(dieSound_);
+  if (mask && ! mask->isEmpty()) {
+    const Mask &playerMask = Assets::mask(Assets::IMAGE_PLAYER);
 
-    bullet->setDead();
+    if (! playerMask.isEmpty() &&
+        mask->sweep(x, y, dy, playerMask, pos_.x - w_/2, pos_.y - h_/2) < 0)
+      return false;
   }
+
+  --lives_;
+
+  invaders_->playSound(Assets::sound(Assets::SOUND_EXPLOSION));
+
+  invaders_->addExplosion(pos_.x, pos_.y, 48, PARTICLE_GREEN, 4.0f);
+
+  if (lives_ <= 0)
+    invaders_->setGameOver();
+
+  return true;
 }
+
+#endif
@@ -0,0 +1,1508 @@
+#ifndef CSpriteMasks_H
+#define CSpriteMasks_H
+
+// Collision masks of the sprite images (pixels with alpha >= 128), rows
+// packed into (w + 63)/64 64 bit words (bit i of word k is column k*64 + i).
+//
+// Generated by tools/masks (CInvadersMasks) from the images, do not edit.
+
+#include <cstdint>
+
+struct SpriteMaskDef {
+  const char     *name; // image file name
+  int             w;
+  int             h;
+  const uint64_t *bits; // h rows of (w + 63)/64 words
+};
+
+constexpr uint64_t spriteMaskBits_base1a_1_1[] = {
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003ffe00,
+  0x00000000003ffe00,
+  0x00000000003ffe00,
+  0x00000000003ffe00,
+  0x00000000003ffff0,
+  0x00000000003ffff0,
+  0x00000000003ffff0,
+  0x00000000003ffff0,
+  0x00000000003ffff0,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+};
+
+constexpr uint64_t spriteMaskBits_base1a_1_2[] = {
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1a_2_1[] = {
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+};
+
+constexpr uint64_t spriteMaskBits_base1a_2_2[] = {
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000000001ff,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1a_3_1[] = {
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+};
+
+constexpr uint64_t spriteMaskBits_base1a_3_2[] = {
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003ff000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1a_4_1[] = {
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x0000000000000fff,
+  0x0000000000000fff,
+  0x0000000000000fff,
+  0x0000000000000fff,
+  0x000000000001ffff,
+  0x000000000001ffff,
+  0x000000000001ffff,
+  0x000000000001ffff,
+  0x000000000001ffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+};
+
+constexpr uint64_t spriteMaskBits_base1a_4_2[] = {
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1b_1_1[] = {
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1fe0,
+  0x00000000003ffe0f,
+  0x00000000003ffe0f,
+  0x00000000003ffe0f,
+  0x00000000003ffe0f,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+};
+
+constexpr uint64_t spriteMaskBits_base1b_1_2[] = {
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x000000000001ffff,
+  0x000000000001ffff,
+  0x000000000001ffff,
+  0x000000000001ffff,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x00000000001fe0ff,
+  0x000000000001fe0f,
+  0x000000000001fe0f,
+  0x000000000001fe0f,
+  0x000000000001fe0f,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1b_2_1[] = {
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+};
+
+constexpr uint64_t spriteMaskBits_base1b_2_2[] = {
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1b_3_1[] = {
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+};
+
+constexpr uint64_t spriteMaskBits_base1b_3_2[] = {
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x000000000021e000,
+  0x000000000021e000,
+  0x000000000021e000,
+  0x000000000021e000,
+  0x000000000021e000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1b_4_1[] = {
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x00000000000000ff,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000000ff0f,
+  0x00000000001e0fff,
+  0x00000000001e0fff,
+  0x00000000001e0fff,
+  0x00000000001e0fff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+};
+
+constexpr uint64_t spriteMaskBits_base1b_4_2[] = {
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001ffff0,
+  0x00000000001ffff0,
+  0x00000000001ffff0,
+  0x00000000001ffff0,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x00000000001fe0ff,
+  0x00000000001e0ff0,
+  0x00000000001e0ff0,
+  0x00000000001e0ff0,
+  0x00000000001e0ff0,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1c_1_1[] = {
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1fe0,
+  0x00000000003e1e0f,
+  0x00000000003e1e0f,
+  0x00000000003e1e0f,
+  0x00000000003e1e0f,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x000000000001fff0,
+  0x000000000001fff0,
+  0x000000000001fff0,
+};
+
+constexpr uint64_t spriteMaskBits_base1c_1_2[] = {
+  0x000000000001fff0,
+  0x000000000001fff0,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x00000000003fe1ff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x000000000001e1f0,
+  0x000000000001e1f0,
+  0x000000000001e1f0,
+  0x000000000001e1f0,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000001c000f,
+  0x0000000000001e00,
+  0x0000000000001e00,
+  0x0000000000001e00,
+  0x0000000000001e00,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1c_2_1[] = {
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003fff0f,
+  0x00000000003fff0f,
+  0x00000000003fff0f,
+  0x00000000003fff0f,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e1ff0,
+  0x00000000003e0ff0,
+  0x00000000003fe0ff,
+  0x00000000003fe0ff,
+  0x00000000003fe0ff,
+  0x00000000003fe0ff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fff0f,
+  0x00000000003fff0f,
+  0x00000000003fff0f,
+};
+
+constexpr uint64_t spriteMaskBits_base1c_2_2[] = {
+  0x00000000003fff0f,
+  0x00000000003ffe0f,
+  0x000000000001e0f0,
+  0x000000000001e0f0,
+  0x000000000001e0f0,
+  0x000000000001e0f0,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1c_3_1[] = {
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x00000000001e1fff,
+  0x00000000001e1fff,
+  0x00000000001e1fff,
+  0x00000000001e1fff,
+  0x000000000021ff0f,
+  0x000000000021ff0f,
+  0x000000000021ff0f,
+  0x000000000021ff0f,
+  0x000000000021fe0f,
+  0x00000000003fe0ff,
+  0x00000000003fe0ff,
+  0x00000000003fe0ff,
+  0x00000000003fe0ff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000003fffff,
+  0x00000000001e1fff,
+  0x00000000001e1fff,
+  0x00000000001e1fff,
+};
+
+constexpr uint64_t spriteMaskBits_base1c_3_2[] = {
+  0x00000000001e1fff,
+  0x00000000001e0fff,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x00000000003e1f0f,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1c_4_1[] = {
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000001ff0f,
+  0x000000000000ff0f,
+  0x00000000001e0f0f,
+  0x00000000001e0f0f,
+  0x00000000001e0f0f,
+  0x00000000001e0f0f,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x000000000001fff0,
+  0x000000000001fff0,
+  0x000000000001fff0,
+};
+
+constexpr uint64_t spriteMaskBits_base1c_4_2[] = {
+  0x000000000001fff0,
+  0x000000000001fff0,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x00000000001ff0ff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x00000000001fffff,
+  0x000000000001f0f0,
+  0x000000000001f0f0,
+  0x000000000001f0f0,
+  0x000000000001f0f0,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e0007,
+  0x0000000000000f00,
+  0x0000000000000f00,
+  0x0000000000000f00,
+  0x0000000000000f00,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1d_1_1[] = {
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000001c0000,
+  0x0000000000001e0f,
+  0x0000000000001e0f,
+  0x0000000000001e0f,
+  0x0000000000001e0f,
+  0x00000000003e01f0,
+  0x00000000003e01f0,
+  0x00000000003e01f0,
+  0x00000000003e01f0,
+  0x0000000000001e00,
+  0x0000000000001e00,
+  0x0000000000001e00,
+};
+
+constexpr uint64_t spriteMaskBits_base1d_1_2[] = {
+  0x0000000000001e00,
+  0x0000000000001e00,
+  0x000000000001e1f0,
+  0x000000000001e1f0,
+  0x000000000001e1f0,
+  0x000000000001e1f0,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000000000e0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x000000000001e000,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000003e000f,
+  0x00000000001c000f,
+  0x0000000000001e00,
+  0x0000000000001e00,
+  0x0000000000001e00,
+  0x0000000000001e00,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1d_2_1[] = {
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x00000000001e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+  0x00000000001e0000,
+  0x0000000000201f0f,
+  0x0000000000201f0f,
+  0x0000000000201f0f,
+  0x0000000000201f0f,
+  0x00000000001e00f0,
+  0x00000000003e00f0,
+  0x00000000003e00f0,
+  0x00000000003e00f0,
+  0x00000000001c00f0,
+  0x000000000020000f,
+  0x000000000020000f,
+  0x000000000020000f,
+  0x000000000000000f,
+  0x000000000001e0f0,
+  0x000000000001e0f0,
+  0x000000000001e0f0,
+  0x000000000001e0f0,
+  0x00000000001e0000,
+  0x00000000003e0000,
+  0x00000000003e0000,
+};
+
+constexpr uint64_t spriteMaskBits_base1d_2_2[] = {
+  0x00000000003e0000,
+  0x00000000001e0000,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1d_3_1[] = {
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x0000000000001f00,
+  0x0000000000000f00,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x00000000001e1f0f,
+  0x00000000001e1f0f,
+  0x00000000001e1f0f,
+  0x00000000001e1f0f,
+  0x000000000021e000,
+  0x000000000021e000,
+  0x000000000021e000,
+  0x000000000021e000,
+  0x000000000001e000,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1d_3_2[] = {
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000001f0f,
+  0x0000000000001f0f,
+  0x0000000000001f0f,
+  0x0000000000001f0f,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x000000000021e0f0,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000200000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_base1d_4_1[] = {
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x0000000000000007,
+  0x00000000001e0f00,
+  0x00000000001e0f00,
+  0x00000000001e0f00,
+  0x00000000001e0f00,
+  0x000000000001f00f,
+  0x000000000001f00f,
+  0x000000000001f00f,
+  0x000000000001f00f,
+  0x0000000000000f00,
+  0x0000000000000f00,
+  0x0000000000000f00,
+};
+
+constexpr uint64_t spriteMaskBits_base1d_4_2[] = {
+  0x0000000000000f00,
+  0x0000000000000f00,
+  0x000000000001f0f0,
+  0x000000000001f0f0,
+  0x000000000001f0f0,
+  0x000000000001f0f0,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x000000000000e000,
+  0x000000000001f000,
+  0x000000000001f000,
+  0x000000000001f000,
+  0x000000000001f000,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000000000f0,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e000f,
+  0x00000000001e0007,
+  0x0000000000000f00,
+  0x0000000000000f00,
+  0x0000000000000f00,
+  0x0000000000000f00,
+  0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_bullet1a[] = {
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+  0x000000000000000f,
+};
+
+constexpr uint64_t spriteMaskBits_bullet2a[] = {
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x000000000000000f,
+  0x000000000000001f,
+  0x000000000000001f,
+  0x000000000000001f,
+  0x000000000000000f,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x000000000000001f,
+  0x000000000000001f,
+  0x000000000000001f,
+  0x000000000000001f,
+  0x00000000000001e0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x00000000000001f0,
+  0x00000000000001e0,
+  0x000000000000001f,
+  0x000000000000001f,
+  0x000000000000001f,
+  0x000000000000001f,
+};
+
+constexpr uint64_t spriteMaskBits_explode1[] = {
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x0000f0007c001e00,
+  0x0000f0007c001e00,
+  0x0000f0007c001e00,
+  0x0000f0007c001e00,
+  0x00000f007c01e000,
+  0x00000f807c03e000,
+  0x00000f807c03e000,
+  0x00000f807c03e000,
+  0x000007007c01c000,
+  0x000000787c3c0000,
+  0x000000787c3c0000,
+  0x000000787c3c0000,
+  0x000000787c3c0000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x01fffff8383fffff,
+  0x01fffff87c3fffff,
+  0x01fffff87c3fffff,
+  0x01fffff87c3fffff,
+  0x01fffff8383fffff,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x0000000000000000,
+  0x000000787c3c0000,
+  0x000000787c3c0000,
+  0x000000787c3c0000,
+  0x000000787c3c0000,
+  0x000007007c01c000,
+  0x00000f807c03e000,
+  0x00000f807c03e000,
+  0x00000f807c03e000,
+  0x00000f007c01e000,
+  0x0000f0007c001e00,
+  0x0000f0007c001e00,
+  0x0000f0007c001e00,
+  0x0000f0007c001e00,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+};
+
+constexpr uint64_t spriteMaskBits_invader1a[] = {
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x0000000003fffe00,
+  0x0000000003fffe00,
+  0x0000000003fffe00,
+  0x0000000003fffe00,
+  0x0000000003fffe00,
+  0x000000007ffffff0,
+  0x000000007ffffff0,
+  0x000000007ffffff0,
+  0x000000007ffffff0,
+  0x00000007fc3fe1ff,
+  0x00000007fc3fe1ff,
+  0x00000007fc3fe1ff,
+  0x00000007fc3fe1ff,
+  0x00000007ffffffff,
+  0x00000007ffffffff,
+  0x00000007ffffffff,
+  0x00000007ffffffff,
+  0x00000007ffffffff,
+  0x0000000003c01e00,
+  0x0000000003c01e00,
+  0x0000000003c01e00,
+  0x0000000003c01e00,
+  0x000000003c3fe1e0,
+  0x000000007c3fe1f0,
+  0x000000007c3fe1f0,
+  0x000000007c3fe1f0,
+  0x00000000381dc0e0,
+  0x0000000783c01e0f,
+  0x0000000783c01e0f,
+  0x0000000783c01e0f,
+  0x0000000783c01e0f,
+};
+
+constexpr uint64_t spriteMaskBits_invader1b[] = {
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x00000000003fe000,
+  0x0000000003fffe00,
+  0x0000000003fffe00,
+  0x0000000003fffe00,
+  0x0000000003fffe00,
+  0x0000000003fffe00,
+  0x000000007ffffff0,
+  0x000000007ffffff0,
+  0x000000007ffffff0,
+  0x000000007ffffff0,
+  0x00000007fc3fe1ff,
+  0x00000007fc3fe1ff,
+  0x00000007fc3fe1ff,
+  0x00000007fc3fe1ff,
+  0x00000007ffffffff,
+  0x00000007ffffffff,
+  0x00000007ffffffff,
+  0x00000007ffffffff,
+  0x00000007ffffffff,
+  0x000000007c3fe1f0,
+  0x000000007c3fe1f0,
+  0x000000007c3fe1f0,
+  0x000000007c3fe1f0,
+  0x000000078000000f,
+  0x000000078000000f,
+  0x000000078000000f,
+  0x000000078000000f,
+  0x000000038000000e,
+  0x000000007c0001f0,
+  0x000000007c0001f0,
+  0x000000007c0001f0,
+  0x000000003c0001e0,
+};
+
+constexpr uint64_t spriteMaskBits_invader2a[] = {
+  0x0000007800001e00,
+  0x0000007800001e00,
+  0x0000007800001e00,
+  0x0000007800001e00,
+  0x0000007f8001c000,
+  0x000000078001e000,
+  0x000000078001e000,
+  0x000000078001e000,
+  0x000000078001e000,
+  0x0000007ffffffe00,
+  0x0000007ffffffe00,
+  0x0000007ffffffe00,
+  0x0000007ffffffe00,
+  0x000007f87ffe1fe0,
+  0x00000ff87ffe1ff0,
+  0x00000ff87ffe1ff0,
+  0x00000ff87ffe1ff0,
+  0x00007ffffffffffe,
+  0x0000ffffffffffff,
+  0x0000ffffffffffff,
+  0x0000ffffffffffff,
+  0x0000ffffffffffff,
+  0x0000f07ffffffe0f,
+  0x0000f07ffffffe0f,
+  0x0000f07ffffffe0f,
+  0x0000f07ffffffe0f,
+  0x0000f07800001e0f,
+  0x0000f07800001e0f,
+  0x0000f07800001e0f,
+  0x0000f07800001e0f,
+  0x0000707800001e0e,
+  0x00000007fc3fe000,
+  0x00000007fc3fe000,
+  0x00000007fc3fe000,
+  0x00000007fc3fe000,
+};
+
+constexpr uint64_t spriteMaskBits_invader2b[] = {
+  0x0000007800001e00,
+  0x0000007800001e00,
+  0x0000007800001e00,
+  0x0000007800001e00,
+  0x0000707f8001c00e,
+  0x0000f0078001e00f,
+  0x0000f0078001e00f,
+  0x0000f0078001e00f,
+  0x0000f0078001e00f,
+  0x0000f07ffffffe0f,
+  0x0000f07ffffffe0f,
+  0x0000f07ffffffe0f,
+  0x0000f07ffffffe0f,
+  0x0000fff87ffe1fff,
+  0x0000fff87ffe1fff,
+  0x0000fff87ffe1fff,
+  0x0000fff87ffe1fff,
+  0x00007ffffffffffe,
+  0x00000ffffffffff0,
+  0x00000ffffffffff0,
+  0x00000ffffffffff0,
+  0x000007ffffffffe0,
+  0x0000007ffffffe00,
+  0x0000007ffffffe00,
+  0x0000007ffffffe00,
+  0x0000007ffffffe00,
+  0x000000078001e000,
+  0x000000078001e000,
+  0x000000078001e000,
+  0x000000078001e000,
+  0x000000038001c000,
+  0x0000007800001e00,
+  0x0000007800001e00,
+  0x0000007800001e00,
+  0x0000007800001e00,
+};
+
+constexpr uint64_t spriteMaskBits_invader3a[] = {
+  0x00000007fffc0000,
+  0x00000007fffc0000,
+  0x00000007fffc0000,
+  0x00000007fffc0000,
+  0x0000ff7fffffdfe0,
+  0x0001fffffffffff0,
+  0x0001fffffffffff0,
+  0x0001fffffffffff0,
+  0x0001fffffffffff0,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fff007fc01fff,
+  0x001fff007fc01fff,
+  0x001fff007fc01fff,
+  0x001fff007fc01fff,
+  0x001ffff7fffdffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x000000ff803fe000,
+  0x000000ff803fe000,
+  0x000000ff803fe000,
+  0x000000ff803fe000,
+  0x00000ff87fc3fe00,
+  0x00000ff87fc3fe00,
+  0x00000ff87fc3fe00,
+  0x00000ff87fc3fe00,
+  0x00000f703b81de00,
+  0x001ff000000001ff,
+  0x001ff000000001ff,
+  0x001ff000000001ff,
+  0x001ff000000001ff,
+};
+
+constexpr uint64_t spriteMaskBits_invader3b[] = {
+  0x00000007fffc0000,
+  0x00000007fffc0000,
+  0x00000007fffc0000,
+  0x00000007fffc0000,
+  0x0000ff7fffffdfe0,
+  0x0001fffffffffff0,
+  0x0001fffffffffff0,
+  0x0001fffffffffff0,
+  0x0001fffffffffff0,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fff007fc01fff,
+  0x001fff007fc01fff,
+  0x001fff007fc01fff,
+  0x001fff007fc01fff,
+  0x001ffff7fffdffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x001fffffffffffff,
+  0x00000fff803ffe00,
+  0x00000fff803ffe00,
+  0x00000fff803ffe00,
+  0x00000fff803ffe00,
+  0x0000ff007fc01fe0,
+  0x0001ff007fc01ff0,
+  0x0001ff007fc01ff0,
+  0x0001ff007fc01ff0,
+  0x0000ff803b803fe0,
+  0x00000ff80003fe00,
+  0x00000ff80003fe00,
+  0x00000ff80003fe00,
+  0x00000ff80003fe00,
+};
+
+constexpr uint64_t spriteMaskBits_mystery1a[] = {
+  0x0000ffffffc00000, 0x0000000000000000,
+  0x0000ffffffc00000, 0x0000000000000000,
+  0x0000ffffffc00000, 0x0000000000000000,
+  0x0000ffffffc00000, 0x0000000000000000,
+  0x00effffffffdc000, 0x0000000000000000,
+  0x01ffffffffffe000, 0x0000000000000000,
+  0x01ffffffffffe000, 0x0000000000000000,
+  0x01ffffffffffe000, 0x0000000000000000,
+  0x01ffffffffffe000, 0x0000000000000000,
+  0x1ffffffffffffe00, 0x0000000000000000,
+  0x1ffffffffffffe00, 0x0000000000000000,
+  0x1ffffffffffffe00, 0x0000000000000000,
+  0x1ffffffffffffe00, 0x0000000000000000,
+  0xfe1ff07f83fe1fe0, 0x0000000000000001,
+  0xfe1ff07f83fe1ff0, 0x0000000000000003,
+  0xfe1ff07f83fe1ff0, 0x0000000000000003,
+  0xfe1ff07f83fe1ff0, 0x0000000000000003,
+  0xfe1ff07f83fe1ff0, 0x0000000000000003,
+  0xffffffffffffffff, 0x000000000000003f,
+  0xffffffffffffffff, 0x000000000000003f,
+  0xffffffffffffffff, 0x000000000000003f,
+  0xffffffffffffffff, 0x000000000000003f,
+  0x1fff007f803ffe00, 0x0000000000000000,
+  0x1fff007f803ffe00, 0x0000000000000000,
+  0x1fff007f803ffe00, 0x0000000000000000,
+  0x1fff007f803ffe00, 0x0000000000000000,
+  0x1ffe007f801ffe00, 0x0000000000000000,
+  0x01f000000003e000, 0x0000000000000000,
+  0x01f000000003e000, 0x0000000000000000,
+  0x01f000000003e000, 0x0000000000000000,
+  0x01f000000003e000, 0x0000000000000000,
+};
+
+constexpr uint64_t spriteMaskBits_player1a[] = {
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x000000007c000000,
+  0x00000007ffc00000,
+  0x00000007ffc00000,
+  0x00000007ffc00000,
+  0x00000007ffc00000,
+  0x00000007ffc00000,
+  0x00000007ffc00000,
+  0x00000007ffc00000,
+  0x00000007ffc00000,
+  0x00000007ffc00000,
+  0x001ffffffffffff0,
+  0x001ffffffffffff0,
+  0x001ffffffffffff0,
+  0x001ffffffffffff0,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+  0x01ffffffffffffff,
+};
+
+constexpr SpriteMaskDef spriteMaskDefs[] = {
+  { "images/base1a_1_1.png", 22, 29, spriteMaskBits_base1a_1_1 },
+  { "images/base1a_1_2.png", 22, 29, spriteMaskBits_base1a_1_2 },
+  { "images/base1a_2_1.png", 22, 29, spriteMaskBits_base1a_2_1 },
+  { "images/base1a_2_2.png", 22, 29, spriteMaskBits_base1a_2_2 },
+  { "images/base1a_3_1.png", 22, 29, spriteMaskBits_base1a_3_1 },
+  { "images/base1a_3_2.png", 22, 29, spriteMaskBits_base1a_3_2 },
+  { "images/base1a_4_1.png", 22, 29, spriteMaskBits_base1a_4_1 },
+  { "images/base1a_4_2.png", 22, 29, spriteMaskBits_base1a_4_2 },
+  { "images/base1b_1_1.png", 22, 29, spriteMaskBits_base1b_1_1 },
+  { "images/base1b_1_2.png", 22, 29, spriteMaskBits_base1b_1_2 },
+  { "images/base1b_2_1.png", 22, 29, spriteMaskBits_base1b_2_1 },
+  { "images/base1b_2_2.png", 22, 29, spriteMaskBits_base1b_2_2 },
+  { "images/base1b_3_1.png", 22, 29, spriteMaskBits_base1b_3_1 },
+  { "images/base1b_3_2.png", 22, 29, spriteMaskBits_base1b_3_2 },
+  { "images/base1b_4_1.png", 22, 29, spriteMaskBits_base1b_4_1 },
+  { "images/base1b_4_2.png", 22, 29, spriteMaskBits_base1b_4_2 },
+  { "images/base1c_1_1.png", 22, 29, spriteMaskBits_base1c_1_1 },
+  { "images/base1c_1_2.png", 22, 29, spriteMaskBits_base1c_1_2 },
+  { "images/base1c_2_1.png", 22, 29, spriteMaskBits_base1c_2_1 },
+  { "images/base1c_2_2.png", 22, 29, spriteMaskBits_base1c_2_2 },
+  { "images/base1c_3_1.png", 22, 29, spriteMaskBits_base1c_3_1 },
+  { "images/base1c_3_2.png", 22, 29, spriteMaskBits_base1c_3_2 },
+  { "images/base1c_4_1.png", 22, 29, spriteMaskBits_base1c_4_1 },
+  { "images/base1c_4_2.png", 22, 29, spriteMaskBits_base1c_4_2 },
+  { "images/base1d_1_1.png", 22, 29, spriteMaskBits_base1d_1_1 },
+  { "images/base1d_1_2.png", 22, 29, spriteMaskBits_base1d_1_2 },
+  { "images/base1d_2_1.png", 22, 29, spriteMaskBits_base1d_2_1 },
+  { "images/base1d_2_2.png", 22, 29, spriteMaskBits_base1d_2_2 },
+  { "images/base1d_3_1.png", 22, 29, spriteMaskBits_base1d_3_1 },
+  { "images/base1d_3_2.png", 22, 29, spriteMaskBits_base1d_3_2 },
+  { "images/base1d_4_1.png", 22, 29, spriteMaskBits_base1d_4_1 },
+  { "images/base1d_4_2.png", 22, 29, spriteMaskBits_base1d_4_2 },
+  { "images/bullet1a.png", 4, 26, spriteMaskBits_bullet1a },
+  { "images/bullet2a.png", 9, 26, spriteMaskBits_bullet2a },
+  { "images/explode1.png", 57, 57, spriteMaskBits_explode1 },
+  { "images/invader1a.png", 35, 35, spriteMaskBits_invader1a },
+  { "images/invader1b.png", 35, 35, spriteMaskBits_invader1b },
+  { "images/invader2a.png", 48, 35, spriteMaskBits_invader2a },
+  { "images/invader2b.png", 48, 35, spriteMaskBits_invader2b },
+  { "images/invader3a.png", 53, 35, spriteMaskBits_invader3a },
+  { "images/invader3b.png", 53, 35, spriteMaskBits_invader3b },
+  { "images/mystery1a.png", 70, 31, spriteMaskBits_mystery1a },
+  { "images/player1a.png", 57, 35, spriteMaskBits_player1a },
+};
+
+constexpr int NUM_SPRITE_MASKS = sizeof(spriteMaskDefs)/sizeof(spriteMaskDefs[0]);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef CTripleBuffer_H
+#define CTripleBuffer_H
+
+#include <atomic>
+
+// Lock-free single producer/single consumer triple buffer.
+//
+// The writer fills back() and publish()es it, the reader update()s to the latest
+// published buffer and reads front(). Neither side ever waits for the other.
+template<typename T>
+class CTripleBuffer {
+ private:
+  enum { INDEX_MASK = 3, DIRTY = 4 };
+
+ public:
+  CTripleBuffer() { }
+
+  // writer
+  T &back() { return buffers_[back_]; }
+
+  void publish() {
+    back_ = middle_.exchange(back_ | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+  }
+
+  // reader
+  bool hasNew() const { return middle_.load(std::memory_order_acquire) & DIRTY; }
+
+  bool update() {
+    if (! hasNew()) return false;
+
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+
+    return true;
+  }
+
+  const T &front() const { return buffers_[front_]; }
+
+  // any buffer (i = 0..2), only for setup before the writer and reader start
+  T &buffer(int i) { return buffers_[i]; }
+
+ private:
+  T                buffers_[3];
+  int              back_   { 0 };
+  std::atomic<int> middle_ { 1 };
+  int              front_  { 2 };
+};
+
+#endif
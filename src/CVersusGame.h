@@ -0,0 +1,98 @@
+#ifndef CVersusGame_H
+#define CVersusGame_H
+
+#include <CInvadersProtocol.h>
+
+// Two player head-to-head game: each player plays their own CSpaceInvaders
+// board from the same seed and the last player left (or the higher score when
+// both boards end on the same tick) wins.
+//
+// Both peers of a networked match simulate both boards from the two players'
+// inputs, so the whole state is deterministic given the seed and the input
+// sequence and can be saved and restored (copyState) for rollback.
+//
+// Include after CSpaceInvaders.h.
+class CVersusGame {
+ public:
+  using Protocol = CInvadersProtocol;
+
+  enum { NUM_PLAYERS = 2 };
+
+ public:
+  CVersusGame(const CLevels *levels=nullptr) :
+   games_{ CSpaceInvaders(levels), CSpaceInvaders(levels) } {
+    for (auto &game : games_) {
+      game.setSoundEnabled  (false);
+      game.setEffectsEnabled(false);
+    }
+  }
+
+  const CSpaceInvaders &game(int player) const { return games_[player]; }
+
+  long tick() const { return tick_; }
+
+  void reset(uint64_t seed) {
+    for (auto &game : games_)
+      game.reset(seed);
+
+    tick_ = 0;
+  }
+
+  // copy state (no allocation) from game using same levels
+  void copyState(const CVersusGame &game) {
+    for (int i = 0; i < NUM_PLAYERS; ++i)
+      games_[i].copyState(game.games_[i]);
+
+    tick_ = game.tick_;
+  }
+
+  // advance both boards one tick with each player's Protocol::Action bits
+  void update(const uint8_t actions[NUM_PLAYERS]) {
+    for (int i = 0; i < NUM_PLAYERS; ++i) {
+      Input input;
+
+      input.left  = (actions[i] & Protocol::ACTION_LEFT );
+      input.right = (actions[i] & Protocol::ACTION_RIGHT);
+      input.fire  = (actions[i] & Protocol::ACTION_FIRE );
+
+      games_[i].setInput(input);
+
+      games_[i].update();
+    }
+
+    ++tick_;
+  }
+
+  bool isOver() const { return games_[0].isGameOver() || games_[1].isGameOver(); }
+
+  // winning player (-1 while playing or for a draw)
+  int winner() const {
+    if (! isOver()) return -1;
+
+    bool over0 = games_[0].isGameOver();
+    bool over1 = games_[1].isGameOver();
+
+    if (over0 != over1) return (over0 ? 1 : 0);
+
+    int score0 = games_[0].getScore();
+    int score1 = games_[1].getScore();
+
+    return (score0 == score1 ? -1 : (score0 > score1 ? 0 : 1));
+  }
+
+  // state hash of both boards (to compare peers)
+  uint64_t checksum() const {
+    uint64_t h = hashMix(uint64_t(tick_));
+
+    for (const auto &game : games_)
+      h = hashCombine(h, game.stateHash());
+
+    return h;
+  }
+
+ private:
+  CSpaceInvaders games_[NUM_PLAYERS];
+  long           tick_ { 0 };
+};
+
+#endif
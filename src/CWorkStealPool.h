@@ -0,0 +1,140 @@
+#ifndef CWorkStealPool_H
+#define CWorkStealPool_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed size thread pool with a task deque per worker.
+//
+// Tasks are dealt round robin to the workers' deques. A worker runs tasks from
+// the back of its own deque and, when that is empty, steals from the front of
+// another worker's deque, so workers which drew short tasks take over the
+// remaining work of those which drew long ones. Tasks are only queued before
+// run(), so a worker which finds nothing to steal sleeps until the last
+// running task finishes. run() blocks until all tasks are done.
+class CWorkStealPool {
+ public:
+  using Task = std::function<void (int worker)>;
+
+ public:
+  CWorkStealPool(int numWorkers=0) {
+    if (numWorkers <= 0)
+      numWorkers = std::max(int(std::thread::hardware_concurrency()), 1);
+
+    for (int i = 0; i < numWorkers; ++i)
+      workers_.push_back(std::make_unique<Worker>());
+  }
+
+  int numWorkers() const { return int(workers_.size()); }
+
+  // number of tasks taken from another worker's deque by last run
+  long numSteals() const { return numSteals_; }
+
+  // queue task (before run)
+  void add(const Task &task) {
+    Worker &worker = *workers_[nextWorker_];
+
+    nextWorker_ = (nextWorker_ + 1) % numWorkers();
+
+    worker.tasks.push_back(task);
+
+    ++numTasks_;
+  }
+
+  // run all queued tasks on the workers
+  void run() {
+    numSteals_ = 0;
+
+    std::vector<std::thread> threads;
+
+    for (int i = 1; i < numWorkers(); ++i)
+      threads.emplace_back([this, i]() { work(i); });
+
+    work(0);
+
+    for (auto &thread : threads)
+      thread.join();
+
+    nextWorker_ = 0;
+  }
+
+ private:
+  struct Worker {
+    std::mutex       mutex;
+    std::deque<Task> tasks;
+  };
+
+  void work(int i) {
+    Task task;
+
+    while (popOwn(i, task) || steal(i, task)) {
+      task(i);
+
+      if (--numTasks_ == 0) {
+        std::lock_guard<std::mutex> lock(doneMutex_);
+
+        done_.notify_all();
+      }
+    }
+
+    // all remaining tasks are running on other workers
+    std::unique_lock<std::mutex> lock(doneMutex_);
+
+    done_.wait(lock, [this]() { return numTasks_ == 0; });
+  }
+
+  bool popOwn(int i, Task &task) {
+    Worker &worker = *workers_[i];
+
+    std::lock_guard<std::mutex> lock(worker.mutex);
+
+    if (worker.tasks.empty()) return false;
+
+    task = std::move(worker.tasks.back());
+
+    worker.tasks.pop_back();
+
+    return true;
+  }
+
+  bool steal(int i, Task &task) {
+    int n = numWorkers();
+
+    for (int j = 1; j < n; ++j) {
+      Worker &victim = *workers_[(i + j) % n];
+
+      std::lock_guard<std::mutex> lock(victim.mutex);
+
+      if (victim.tasks.empty()) continue;
+
+      task = std::move(victim.tasks.front());
+
+      victim.tasks.pop_front();
+
+      ++numSteals_;
+
+      return true;
+    }
+
+    return false;
+  }
+
+ private:
+  using Workers = std::vector<std::unique_ptr<Worker>>;
+
+  Workers                 workers_;
+  int                     nextWorker_ { 0 };
+  std::atomic<long>       numTasks_   { 0 };
+  std::atomic<long>       numSteals_  { 0 };
+  std::mutex              doneMutex_;
+  std::condition_variable done_;
+};
+
+#endif
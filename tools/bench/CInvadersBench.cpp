@@ -0,0 +1,155 @@
+#include <CNullApp.h>
+#include <CSpaceInvaders.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Swarm scaling benchmark.
+//
+// For each formation size a single generated wave (packed formation, many
+// player and alien bullets, no row drops) is played headless for a fixed
+// number of ticks with a scripted sweep-and-fire input, once with the grid
+// broadphase and once with the linear hit scan. Both runs must give the same
+// score (the broadphase only changes which entities are tested).
+
+static WaveDef
+swarmWave(int numAliens)
+{
+  WaveDef wave;
+
+  wave.cols = std::min(std::max(int(std::ceil(std::sqrt(2.0*numAliens))), 1), 60);
+  wave.rows = std::min((numAliens + wave.cols - 1)/wave.cols, int(WaveDef::MAX_FORMATION_ROWS));
+
+  wave.colX  = 130;
+  wave.colDX = std::max(540/wave.cols, 1);
+  wave.rowY  = 70;
+  wave.rowDY = std::max(480/wave.rows, 1);
+
+  wave.speed    = 4;
+  wave.speedInc = 0;
+  wave.drop     = 0;
+
+  wave.playerBullets = 64;
+  wave.alienBullets  = 400;
+  wave.fireDelay     = 1;
+
+  // a few new alien bullets per tick whatever the size
+  wave.fireProb = float(4.0/(wave.rows*wave.cols));
+
+  return wave;
+}
+
+struct RunResult {
+  double msPerTick { 0.0 };
+  int    score     { 0 };
+};
+
+static RunResult
+run(const CLevels &levels, bool broadphase, int numTicks, uint64_t seed)
+{
+  CSpaceInvaders game(&levels);
+
+  game.setSoundEnabled     (false);
+  game.setEffectsEnabled   (false);
+  game.setBroadphaseEnabled(broadphase);
+
+  game.reset(seed);
+
+  int score = 0;
+
+  auto t1 = std::chrono::steady_clock::now();
+
+  for (int t = 0; t < numTicks; ++t) {
+    if (game.isGameOver()) {
+      score += game.getScore();
+
+      game.reset(seed + t);
+    }
+
+    // sweep across the screen firing continuously
+    Input input;
+
+    bool left = ((t/100) & 1);
+
+    input.left  = left;
+    input.right = ! left;
+    input.fire  = true;
+
+    game.setInput(input);
+
+    game.update();
+  }
+
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+
+  RunResult result;
+
+  result.msPerTick = 1000.0*secs/numTicks;
+  result.score     = score + game.getScore();
+
+  return result;
+}
+
+static void
+usage()
+{
+  std::cerr << "Usage: CInvadersBench [-sizes <n,n,...>] [-ticks <n>] [-seed <n>]" << std::endl;
+}
+
+int
+main(int argc, char **argv)
+{
+  std::vector<int> sizes    = { 55, 250, 1000, 2000, 4000, 8000 };
+  int              numTicks = 2000;
+  uint64_t         seed     = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-sizes") == 0 && i < argc - 1) {
+      sizes.clear();
+
+      std::istringstream is(argv[++i]);
+
+      std::string size;
+
+      while (std::getline(is, size, ','))
+        sizes.push_back(std::max(atoi(size.c_str()), 1));
+    }
+    else if (strcmp(argv[i], "-ticks") == 0 && i < argc - 1)
+      numTicks = std::max(atoi(argv[++i]), 1);
+    else if (strcmp(argv[i], "-seed") == 0 && i < argc - 1)
+      seed = strtoull(argv[++i], nullptr, 10);
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  printf("%8s %14s %14s %10s\n", "Aliens", "Grid ms/tick", "Linear ms/tick", "Score");
+
+  int rc = 0;
+
+  for (int size : sizes) {
+    WaveDef wave = swarmWave(size);
+
+    CLevels levels;
+
+    levels.setWaves(CLevels::Waves(1, wave));
+
+    RunResult grid   = run(levels, true , numTicks, seed);
+    RunResult linear = run(levels, false, numTicks, seed);
+
+    printf("%8d %14.4f %14.4f %10d%s\n", wave.rows*wave.cols, grid.msPerTick,
+           linear.msPerTick, grid.score, (grid.score != linear.score ? " MISMATCH" : ""));
+
+    if (grid.score != linear.score)
+      rc = 1;
+  }
+
+  return rc;
+}
@@ -0,0 +1,17 @@
+TEMPLATE = app
+
+TARGET = CInvadersBench
+
+CONFIG -= qt
+CONFIG += console
+
+QMAKE_CXXFLAGS += -std=c++17
+
+INCLUDEPATH += . ../../src
+
+# Input
+HEADERS += ../../src/CSpaceInvaders.h ../../src/CSpriteMasks.h ../../src/CNullApp.h ../../src/CAudioMixer.h ../../src/CInvadersPolicy.h
+SOURCES += CInvadersBench.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../obj/bench
@@ -0,0 +1,345 @@
+#include <CNullApp.h>
+#include <CSpaceInvaders.h>
+#include <CInvadersPolicy.h>
+#include <CReplay.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Finds the first tick where two runs of the game diverge, using the per tick
+// state hash (CSpaceInvaders::stateHash).
+//
+// A replay (recorded with its state hashes) is played back and checked
+// against its recorded hashes, which compares this build and machine with the
+// recording one. Without a replay a scripted bot game is played from a seed,
+// which can be saved as a replay to check on another build or machine.
+//
+// The run's sound can be mixed offline (CAudioMixer) and written as a WAV;
+// its hash is reported so audio can be compared across runs too.
+//
+// Either run can write a trace of the per tick section hashes (aliens,
+// bullets, ...) and two traces from different builds or machines are compared
+// to report the first divergent tick and which parts of the state differ.
+
+using Hashes = uint64_t[CSpaceInvaders::NUM_HASH_SECTIONS];
+
+// scripted bot game as a replay with state hashes (restarting at game over)
+static CReplay
+botReplay(const CLevels &levels, uint64_t seed, int numTicks)
+{
+  CReplay replay(seed);
+
+  CSpaceInvaders game(&levels);
+
+  game.setSoundEnabled  (false);
+  game.setEffectsEnabled(false);
+
+  game.reset(seed);
+
+  CScriptedPolicy policy;
+
+  for (int t = 0; t < numTicks; ++t) {
+    uint8_t flags = 0;
+
+    if (game.isGameOver())
+      flags |= CReplay::RESTART;
+
+    uint8_t action = policy.act(game);
+
+    if (action & CInvadersProtocol::ACTION_LEFT ) flags |= CReplay::LEFT;
+    if (action & CInvadersProtocol::ACTION_RIGHT) flags |= CReplay::RIGHT;
+    if (action & CInvadersProtocol::ACTION_FIRE ) flags |= CReplay::FIRE;
+
+    replay.addTick(flags);
+
+    CReplay::applyTick(game, flags);
+
+    replay.addHash(game.stateHash());
+  }
+
+  return replay;
+}
+
+static bool
+writeTraceLine(FILE *fp, int tick, uint64_t hash, const Hashes &hashes)
+{
+  fprintf(fp, "%d %016" PRIx64, tick, hash);
+
+  for (int i = 0; i < CSpaceInvaders::NUM_HASH_SECTIONS; ++i)
+    fprintf(fp, " %016" PRIx64, hashes[i]);
+
+  return fprintf(fp, "\n") > 0;
+}
+
+// play replay, checking recorded hashes and optionally writing a trace
+static bool
+play(const CLevels &levels, const CReplay &replay, const std::string &traceFile,
+     const std::string &wavFile, bool verify)
+{
+  FILE *fp = nullptr;
+
+  if (traceFile != "") {
+    fp = fopen(traceFile.c_str(), "w");
+
+    if (! fp) {
+      std::cerr << "Error: Failed to write trace '" << traceFile << "'" << std::endl;
+      return false;
+    }
+
+    fprintf(fp, "# CQInvaders state trace seed %" PRIu64 "\n", replay.seed());
+    fprintf(fp, "# tick hash");
+
+    for (int i = 0; i < CSpaceInvaders::NUM_HASH_SECTIONS; ++i)
+      fprintf(fp, " %s", CSpaceInvaders::hashSectionName(i));
+
+    fprintf(fp, "\n");
+  }
+
+  CSpaceInvaders game(&levels);
+
+  CAudioMixer mixer;
+
+  game.setSoundEnabled  (wavFile != "");
+  game.setEffectsEnabled(false);
+
+  if (wavFile != "")
+    App::setMixer(&mixer);
+
+  game.reset(replay.seed());
+
+  int firstDiff = -1;
+  int badHash   = -1;
+
+  for (int t = 0; t < replay.numTicks(); ++t) {
+    CReplay::applyTick(game, replay.tick(t));
+
+    if (wavFile != "")
+      mixer.mixTick();
+
+    uint64_t hash = game.stateHash();
+
+    if (firstDiff < 0 && ! replay.checkHash(t, hash))
+      firstDiff = t;
+
+    if (verify && badHash < 0 && ! game.checkStateHash())
+      badHash = t;
+
+    if (fp) {
+      Hashes hashes;
+
+      game.stateHashes(hashes);
+
+      writeTraceLine(fp, t, hash, hashes);
+    }
+  }
+
+  if (fp)
+    fclose(fp);
+
+  bool rc = true;
+
+  if (wavFile != "") {
+    App::setMixer(nullptr);
+
+    if (! mixer.writeWav(wavFile))
+      rc = false;
+
+    std::cout << "Audio: " << mixer.samples().size() << " samples, hash " << std::hex <<
+                 mixer.hash() << std::dec << std::endl;
+  }
+
+  if (badHash >= 0) {
+    std::cout << "Incremental state hash wrong at tick " << badHash << std::endl;
+    rc = false;
+  }
+
+  if      (replay.numHashes() == 0)
+    std::cout << "Played " << replay.numTicks() << " ticks (no recorded hashes)" << std::endl;
+  else if (firstDiff >= 0) {
+    // traces (-trace) from both builds show which parts differ
+    std::cout << "First divergent tick " << firstDiff << " (of " << replay.numTicks() <<
+                 ")" << std::endl;
+    rc = false;
+  }
+  else
+    std::cout << "Replay matches recording (" << replay.numHashes() << " ticks)" << std::endl;
+
+  return rc;
+}
+
+//---
+
+struct TraceTick {
+  int      tick { 0 };
+  uint64_t hash { 0 };
+  Hashes   hashes = {};
+};
+
+using Trace = std::vector<TraceTick>;
+
+static bool
+readTrace(const std::string &filename, Trace &trace)
+{
+  FILE *fp = fopen(filename.c_str(), "r");
+
+  if (! fp) {
+    std::cerr << "Error: Failed to read trace '" << filename << "'" << std::endl;
+    return false;
+  }
+
+  char line[512];
+
+  bool ok = true;
+
+  while (ok && fgets(line, sizeof(line), fp)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+
+    TraceTick t;
+
+    const char *p = line;
+
+    int n;
+
+    ok = (sscanf(p, "%d %" SCNx64 "%n", &t.tick, &t.hash, &n) == 2);
+
+    for (int i = 0; ok && i < CSpaceInvaders::NUM_HASH_SECTIONS; ++i) {
+      p += n;
+
+      ok = (sscanf(p, " %" SCNx64 "%n", &t.hashes[i], &n) == 1);
+    }
+
+    if (ok)
+      trace.push_back(t);
+  }
+
+  fclose(fp);
+
+  if (! ok)
+    std::cerr << "Error: Invalid trace '" << filename << "'" << std::endl;
+
+  return ok;
+}
+
+// compare traces tick by tick (same tick numbering)
+static bool
+compare(const std::string &file1, const std::string &file2)
+{
+  Trace trace1, trace2;
+
+  if (! readTrace(file1, trace1) || ! readTrace(file2, trace2))
+    return false;
+
+  size_t n = std::min(trace1.size(), trace2.size());
+
+  for (size_t i = 0; i < n; ++i) {
+    const TraceTick &t1 = trace1[i];
+    const TraceTick &t2 = trace2[i];
+
+    if (t1.tick == t2.tick && t1.hash == t2.hash) continue;
+
+    if (t1.tick != t2.tick) {
+      std::cout << "Traces do not line up at line " << i << " (ticks " << t1.tick <<
+                   " and " << t2.tick << ")" << std::endl;
+      return false;
+    }
+
+    std::cout << "First divergent tick " << t1.tick << ", differs in:";
+
+    for (int s = 0; s < CSpaceInvaders::NUM_HASH_SECTIONS; ++s) {
+      if (t1.hashes[s] != t2.hashes[s])
+        std::cout << " " << CSpaceInvaders::hashSectionName(s);
+    }
+
+    std::cout << std::endl;
+
+    return false;
+  }
+
+  if (trace1.size() != trace2.size()) {
+    std::cout << "Traces match for " << n << " ticks but differ in length (" <<
+                 trace1.size() << " and " << trace2.size() << ")" << std::endl;
+    return false;
+  }
+
+  std::cout << "Traces match (" << n << " ticks)" << std::endl;
+
+  return true;
+}
+
+//---
+
+static void
+usage()
+{
+  std::cerr << "Usage: CInvadersBisect [-replay <file> | -seed <n> -ticks <n>] " <<
+               "[-save <file>] [-trace <file>] [-wav <file>] [-verify] [-levels <file>]\n"
+               "       CInvadersBisect -compare <trace1> <trace2>" << std::endl;
+}
+
+int
+main(int argc, char **argv)
+{
+  std::string replayFile;
+  std::string traceFile;
+  std::string saveFile;
+  std::string wavFile;
+  std::string levelsFile;
+  std::string compareFile1, compareFile2;
+  uint64_t    seed     = 1;
+  int         numTicks = 10000;
+  bool        verify   = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-replay") == 0 && i < argc - 1)
+      replayFile = argv[++i];
+    else if (strcmp(argv[i], "-seed") == 0 && i < argc - 1)
+      seed = strtoull(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "-ticks") == 0 && i < argc - 1)
+      numTicks = std::max(atoi(argv[++i]), 1);
+    else if (strcmp(argv[i], "-save") == 0 && i < argc - 1)
+      saveFile = argv[++i];
+    else if (strcmp(argv[i], "-trace") == 0 && i < argc - 1)
+      traceFile = argv[++i];
+    else if (strcmp(argv[i], "-wav") == 0 && i < argc - 1)
+      wavFile = argv[++i];
+    else if (strcmp(argv[i], "-verify") == 0)
+      verify = true;
+    else if (strcmp(argv[i], "-levels") == 0 && i < argc - 1)
+      levelsFile = argv[++i];
+    else if (strcmp(argv[i], "-compare") == 0 && i < argc - 2) {
+      compareFile1 = argv[++i];
+      compareFile2 = argv[++i];
+    }
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (compareFile1 != "")
+    return (compare(compareFile1, compareFile2) ? 0 : 1);
+
+  CLevels levels;
+
+  if (levelsFile != "" && ! levels.load(levelsFile))
+    return 1;
+
+  CReplay replay;
+
+  if (replayFile != "") {
+    if (! replay.load(replayFile))
+      return 1;
+  }
+  else {
+    replay = botReplay(levels, seed, numTicks);
+
+    if (saveFile != "" && ! replay.save(saveFile))
+      return 1;
+  }
+
+  return (play(levels, replay, traceFile, wavFile, verify) ? 0 : 1);
+}
@@ -0,0 +1,18 @@
+TEMPLATE = app
+
+TARGET = CInvadersBisect
+
+CONFIG -= qt
+CONFIG += console
+
+QMAKE_CXXFLAGS += -std=c++17
+
+INCLUDEPATH += . ../../src
+
+# Input
+HEADERS += ../../src/CSpaceInvaders.h ../../src/CSpriteMasks.h ../../src/CNullApp.h ../../src/CAudioMixer.h ../../src/CInvadersPolicy.h \
+           ../../src/CReplay.h
+SOURCES += CInvadersBisect.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../obj/bisect
@@ -0,0 +1,315 @@
+#include <CNullApp.h>
+#include <CSpaceInvaders.h>
+#include <CInvadersObs.h>
+#include <CInvadersPolicy.h>
+#include <CSearchPolicy.h>
+#include <CWorkStealPool.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+
+// Plays complete headless games for a range of seeds with a bot policy and
+// reports per seed results (CSV) and summary statistics.
+//
+// Policies are the built-in scripted or lookahead search bots (search is single
+// threaded here as episodes already use all cores) or a shared object exporting:
+//
+//   void   *invaders_policy_create (uint64_t seed);
+//   uint8_t invaders_policy_act    (void *policy, const void *obs, size_t size);
+//   void    invaders_policy_destroy(void *policy);
+//
+// where obs is the CInvadersProtocol observation (see CInvadersObs.h) and the
+// result is CInvadersProtocol::Action bits.
+//
+// Episode lengths vary widely (waves repeat until the player dies) so seeds
+// are run as separate tasks on a work stealing pool.
+
+// policy loaded from shared object
+class CSharedPolicy : public CInvadersPolicy {
+ public:
+  using CreateProc  = void   *(*)(uint64_t);
+  using ActProc     = uint8_t (*)(void *, const void *, size_t);
+  using DestroyProc = void    (*)(void *);
+
+  struct Procs {
+    CreateProc  create  { nullptr };
+    ActProc     act     { nullptr };
+    DestroyProc destroy { nullptr };
+  };
+
+ public:
+  static bool load(const std::string &filename, Procs &procs) {
+    void *handle = dlopen(filename.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+    if (! handle) {
+      std::cerr << "Error: " << dlerror() << std::endl;
+      return false;
+    }
+
+    procs.create  = reinterpret_cast<CreateProc >(dlsym(handle, "invaders_policy_create"));
+    procs.act     = reinterpret_cast<ActProc    >(dlsym(handle, "invaders_policy_act"));
+    procs.destroy = reinterpret_cast<DestroyProc>(dlsym(handle, "invaders_policy_destroy"));
+
+    if (! procs.create || ! procs.act || ! procs.destroy) {
+      std::cerr << "Error: Missing invaders_policy functions in '" << filename << "'" << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  CSharedPolicy(const Procs &procs, size_t maxObsSize) :
+   procs_(procs), obs_(maxObsSize) {
+  }
+
+ ~CSharedPolicy() {
+    if (policy_)
+      procs_.destroy(policy_);
+  }
+
+  void reset(uint64_t seed) override {
+    if (policy_)
+      procs_.destroy(policy_);
+
+    policy_ = procs_.create(seed);
+  }
+
+  uint8_t act(const CSpaceInvaders &game) override {
+    size_t size = CInvadersObs::encode(game, 0, &obs_[0]);
+
+    return procs_.act(policy_, &obs_[0], size);
+  }
+
+ private:
+  Procs             procs_;
+  std::vector<char> obs_;
+  void             *policy_ { nullptr };
+};
+
+//---
+
+struct EpisodeResult {
+  uint64_t seed      { 0 };
+  int      score     { 0 };
+  int      level     { 0 };
+  int      livesLost { 0 };
+  long     ticks     { 0 };
+  bool     gameOver  { false };
+};
+
+static void
+usage()
+{
+  std::cerr << "Usage: CInvadersEval [-policy scripted|search|<file.so>] " <<
+               "[-seeds <first> <count>] [-threads <n>] [-max_ticks <n>] [-rollouts <n>] " <<
+               "[-repeat <n>] [-csv <file>] [-levels <file>]" << std::endl;
+}
+
+int
+main(int argc, char **argv)
+{
+  std::string policyName = "scripted";
+  uint64_t    firstSeed  = 1;
+  long        numSeeds   = 1000;
+  int         numThreads = 0;
+  long        maxTicks   = 100000;
+  int         rollouts   = 60;
+  int         repeat     = 1;
+  std::string csvFile;
+  std::string levelsFile;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-policy") == 0 && i < argc - 1)
+      policyName = argv[++i];
+    else if (strcmp(argv[i], "-seeds") == 0 && i < argc - 2) {
+      firstSeed = strtoull(argv[++i], nullptr, 10);
+      numSeeds  = atol(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-threads") == 0 && i < argc - 1)
+      numThreads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-max_ticks") == 0 && i < argc - 1)
+      maxTicks = atol(argv[++i]);
+    else if (strcmp(argv[i], "-rollouts") == 0 && i < argc - 1)
+      rollouts = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-repeat") == 0 && i < argc - 1)
+      repeat = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-csv") == 0 && i < argc - 1)
+      csvFile = argv[++i];
+    else if (strcmp(argv[i], "-levels") == 0 && i < argc - 1)
+      levelsFile = argv[++i];
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  CLevels levels;
+
+  if (levelsFile != "" && ! levels.load(levelsFile))
+    return 1;
+
+  CSharedPolicy::Procs procs;
+
+  bool search = (policyName == "search");
+  bool shared = (policyName != "scripted" && ! search);
+
+  if (shared && ! CSharedPolicy::load(policyName, procs))
+    return 1;
+
+  CWorkStealPool pool(numThreads);
+
+  // per worker game and policy (reused for every episode the worker runs)
+  using GameP   = std::unique_ptr<CSpaceInvaders>;
+  using PolicyP = std::unique_ptr<CInvadersPolicy>;
+
+  std::vector<GameP>   games;
+  std::vector<PolicyP> policies;
+
+  for (int i = 0; i < pool.numWorkers(); ++i) {
+    games.push_back(std::make_unique<CSpaceInvaders>(&levels));
+
+    games.back()->setActionRepeat  (repeat);
+    games.back()->setEffectsEnabled(false);
+
+    if      (shared)
+      policies.push_back(std::make_unique<CSharedPolicy>(procs, CInvadersObs::maxSize(levels)));
+    else if (search) {
+      // fixed rollout count (no time budget) so results are reproducible
+      CSearchPolicy::Params params;
+
+      params.numThreads  = 1;
+      params.budget      = 0.0;
+      params.maxRollouts = rollouts;
+      params.horizon     = 60;
+
+      policies.push_back(std::make_unique<CSearchPolicy>(&levels, params));
+    }
+    else
+      policies.push_back(std::make_unique<CScriptedPolicy>());
+  }
+
+  std::vector<EpisodeResult> results(numSeeds);
+
+  for (long i = 0; i < numSeeds; ++i) {
+    pool.add([&, i](int worker) {
+      CSpaceInvaders  &game   = *games   [worker];
+      CInvadersPolicy &policy = *policies[worker];
+
+      EpisodeResult &result = results[i];
+
+      result.seed = firstSeed + i;
+
+      game  .reset(result.seed);
+      policy.reset(result.seed);
+
+      int startLives = game.getLives();
+
+      while (! game.isGameOver() && game.getTick() < maxTicks) {
+        uint8_t action = policy.act(game);
+
+        Input input;
+
+        input.left  = (action & CInvadersProtocol::ACTION_LEFT );
+        input.right = (action & CInvadersProtocol::ACTION_RIGHT);
+        input.fire  = (action & CInvadersProtocol::ACTION_FIRE );
+
+        game.setInput(input);
+
+        game.step();
+      }
+
+      result.score     = game.getScore();
+      result.level     = game.getLevel();
+      result.livesLost = startLives - game.getLives();
+      result.ticks     = game.getTick();
+      result.gameOver  = game.isGameOver();
+    });
+  }
+
+  auto t1 = std::chrono::steady_clock::now();
+
+  pool.run();
+
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+
+  //---
+
+  if (csvFile != "") {
+    std::ofstream os(csvFile);
+
+    if (! os) {
+      std::cerr << "Error: Failed to write '" << csvFile << "'" << std::endl;
+      return 1;
+    }
+
+    os << "seed,score,level,lives_lost,ticks,game_over\n";
+
+    for (const auto &result : results)
+      os << result.seed << "," << result.score << "," << result.level << "," <<
+            result.livesLost << "," << result.ticks << "," << int(result.gameOver) << "\n";
+  }
+
+  //---
+
+  struct Stat {
+    double sum { 0 }, sum2 { 0 }, min { 1e300 }, max { -1e300 };
+
+    void add(double v) { sum += v; sum2 += v*v; min = std::min(min, v); max = std::max(max, v); }
+
+    void print(const char *name, long n) const {
+      double mean = sum/n;
+      double sdev = std::sqrt(std::max(sum2/n - mean*mean, 0.0));
+
+      std::cout << name << ": mean " << mean << " sdev " << sdev <<
+                   " min " << min << " max " << max << "\n";
+    }
+  };
+
+  Stat score, level, livesLost, ticks;
+
+  long totalTicks = 0, numTruncated = 0;
+
+  for (const auto &result : results) {
+    score    .add(result.score);
+    level    .add(result.level);
+    livesLost.add(result.livesLost);
+    ticks    .add(double(result.ticks));
+
+    totalTicks += result.ticks;
+
+    if (! result.gameOver) ++numTruncated;
+  }
+
+  if (numSeeds > 0) {
+    std::cout << "Episodes: " << numSeeds << " (" << numTruncated << " hit max ticks)\n";
+
+    score    .print("Score"     , numSeeds);
+    level    .print("Level"     , numSeeds);
+    livesLost.print("Lives lost", numSeeds);
+    ticks    .print("Ticks"     , numSeeds);
+  }
+
+  if (search) {
+    long numRollouts = 0;
+
+    for (const auto &policy : policies)
+      numRollouts += static_cast<const CSearchPolicy *>(policy.get())->numRollouts();
+
+    std::cout << "Rollouts: " << numRollouts << " (" <<
+                 numRollouts/std::max(secs, 1e-9) << " rollouts/s)\n";
+  }
+
+  std::cout << "Time: " << secs << "s, " << pool.numWorkers() << " threads, " <<
+               totalTicks/std::max(secs, 1e-9) << " ticks/s, " <<
+               pool.numSteals() << " steals" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,20 @@
+TEMPLATE = app
+
+TARGET = CInvadersEval
+
+CONFIG -= qt
+CONFIG += console
+
+QMAKE_CXXFLAGS += -std=c++17
+
+INCLUDEPATH += . ../../src
+
+# Input
+HEADERS += ../../src/CSpaceInvaders.h ../../src/CSpriteMasks.h ../../src/CNullApp.h ../../src/CAudioMixer.h ../../src/CInvadersPolicy.h \
+           ../../src/CInvadersObs.h ../../src/CWorkStealPool.h ../../src/CSearchPolicy.h
+SOURCES += CInvadersEval.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../obj/eval
+
+unix:LIBS += -ldl -lpthread
@@ -0,0 +1,496 @@
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <CDrawListPainter.h>
+#include <CAudioMixer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Offscreen backend: draw calls are recorded into the calling thread's draw
+// list and painted into a QImage by CDrawListPainter, as in the GUI (no window
+// system needed). Sounds are mixed by the calling thread's offline mixer if
+// any.
+
+struct Sound {
+  std::string    filename;
+  CAudioClip     clip;
+  std::once_flag loaded;
+
+  Sound(const std::string &filename1) :
+   filename(filename1) {
+  }
+};
+
+class App {
+ public:
+  // not thread safe (all games are created on the main thread)
+  static Image *loadImage(const char *filename) {
+    auto p = images_.find(filename);
+
+    if (p != images_.end())
+      return (*p).second.get();
+
+    QImage qimage;
+
+    if (! qimage.load(filename))
+      std::cerr << "Error: Failed to load image '" << filename << "'" << std::endl;
+
+    Image *image = new Image(qimage.convertToFormat(QImage::Format_ARGB32_Premultiplied), filename);
+
+    images_[filename].reset(image);
+
+    return image;
+  }
+
+  static Sound *loadSound(const char *filename) {
+    auto &sound = sounds_[filename];
+
+    if (! sound)
+      sound.reset(new Sound(filename));
+
+    return sound.get();
+  }
+
+  static void drawImage(int x, int y, Image *image) {
+    drawList_->addImage(x, y, image);
+  }
+
+  static void fillRect(int x, int y, int w, int h, uint32_t color) {
+    drawList_->addRect(x, y, w, h, color);
+  }
+
+  static void drawLeftText(int x, int y, const char *str) {
+    drawList_->addText(CDrawList::Type::LEFT_TEXT, x, y, str);
+  }
+
+  static void drawCenteredText(int x, int y, const char *str) {
+    drawList_->addText(CDrawList::Type::CENTERED_TEXT, x, y, str);
+  }
+
+  static void drawRightText(int x, int y, const char *str) {
+    drawList_->addText(CDrawList::Type::RIGHT_TEXT, x, y, str);
+  }
+
+  static void playSound(Sound *sound) {
+    if (! mixer_) return;
+
+    std::call_once(sound->loaded, [sound]() { sound->clip.load(sound->filename); });
+
+    mixer_->play(&sound->clip);
+  }
+
+  static void setDrawList(CDrawList *drawList) { drawList_ = drawList; }
+
+  static void setMixer(CAudioMixer *mixer) { mixer_ = mixer; }
+
+ private:
+  using ImageList = std::map<std::string, std::unique_ptr<Image>>;
+  using SoundList = std::map<std::string, std::unique_ptr<Sound>>;
+
+  static ImageList                 images_;
+  static SoundList                 sounds_;
+  static thread_local CDrawList   *drawList_;
+  static thread_local CAudioMixer *mixer_;
+};
+
+App::ImageList            App::images_;
+App::SoundList            App::sounds_;
+thread_local CDrawList   *App::drawList_ = nullptr;
+thread_local CAudioMixer *App::mixer_    = nullptr;
+
+#include <CSpaceInvaders.h>
+#include <CReplay.h>
+
+//------
+
+// Renders a replay to a Y4M video or PNG sequence.
+//
+// A fast simulation-only pass snapshots the game every chunkTicks ticks, then
+// the chunks are rendered concurrently, each from its snapshot. Y4M frames
+// have a fixed size so every chunk writes straight to its final file offset.
+// Audio (optional) is mixed offline during the simulation pass, one tick of
+// samples per frame, and written as a WAV.
+class CInvadersExport {
+ public:
+  CInvadersExport(const CLevels *levels, const CReplay &replay) :
+   levels_(levels), replay_(replay) {
+  }
+
+  void setChunkTicks(int n) { chunkTicks_ = std::max(n, 1); }
+
+  void setNumThreads(int n) { numThreads_ = std::max(n, 1); }
+
+  // also write audio to WAV file
+  void setWavFile(const std::string &filename) { wavFile_ = filename; }
+
+  bool exportY4M(const std::string &filename);
+
+  bool exportPNG(const std::string &dirname);
+
+ private:
+  enum class Format {
+    Y4M,
+    PNG
+  };
+
+  bool exec();
+
+  void snapshot();
+
+  void renderChunk(int chunk);
+
+  void writeFrame(int frame, const QImage &image, std::vector<uint8_t> &data);
+
+ private:
+  using Snapshots = std::vector<std::unique_ptr<CSpaceInvaders>>;
+
+  const CLevels    *levels_      { nullptr };
+  const CReplay    &replay_;
+  int               chunkTicks_  { 300 };
+  int               numThreads_  { 1 };
+  Format            format_      { Format::Y4M };
+  std::string       filename_;
+  int               fd_          { -1 };
+  size_t            headerSize_  { 0 };
+  Snapshots         snapshots_;
+  std::string       wavFile_;
+  CAudioMixer       mixer_;
+  std::atomic<int>  nextChunk_   { 0 };
+  std::atomic<bool> failed_      { false };
+};
+
+//------
+
+static void
+usage()
+{
+  std::cerr << "Usage: CInvadersExport -replay <file> -o <file.y4m|dir> [-threads <n>] " <<
+               "[-chunk <ticks>] [-wav <file>] [-levels <file>] [-dir <asset_dir>]" << std::endl;
+}
+
+int
+main(int argc, char **argv)
+{
+  // render without a display
+  if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  QGuiApplication app(argc, argv);
+
+  std::string replayFile;
+  std::string outFile;
+  std::string levelsFile;
+  std::string assetDir;
+  std::string wavFile;
+  int         numThreads = int(std::thread::hardware_concurrency());
+  int         chunkTicks = 300;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-replay") == 0 && i < argc - 1)
+      replayFile = argv[++i];
+    else if (strcmp(argv[i], "-o") == 0 && i < argc - 1)
+      outFile = argv[++i];
+    else if (strcmp(argv[i], "-threads") == 0 && i < argc - 1)
+      numThreads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-chunk") == 0 && i < argc - 1)
+      chunkTicks = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-levels") == 0 && i < argc - 1)
+      levelsFile = argv[++i];
+    else if (strcmp(argv[i], "-wav") == 0 && i < argc - 1)
+      wavFile = argv[++i];
+    else if (strcmp(argv[i], "-dir") == 0 && i < argc - 1)
+      assetDir = argv[++i];
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (replayFile == "" || outFile == "") {
+    usage();
+    return 1;
+  }
+
+  CReplay replay;
+
+  if (! replay.load(replayFile))
+    return 1;
+
+  CLevels levels;
+
+  if (levelsFile != "" && ! levels.load(levelsFile))
+    return 1;
+
+  // images are loaded relative to asset dir
+  if (assetDir != "" && chdir(assetDir.c_str()) != 0) {
+    std::cerr << "Error: Invalid asset dir '" << assetDir << "'" << std::endl;
+    return 1;
+  }
+
+  CInvadersExport exporter(&levels, replay);
+
+  exporter.setNumThreads(numThreads);
+  exporter.setChunkTicks(chunkTicks);
+  exporter.setWavFile   (wavFile);
+
+  auto t1 = std::chrono::steady_clock::now();
+
+  bool rc;
+
+  if (outFile.size() > 4 && outFile.substr(outFile.size() - 4) == ".y4m")
+    rc = exporter.exportY4M(outFile);
+  else
+    rc = exporter.exportPNG(outFile);
+
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+
+  if (rc)
+    std::cerr << "Exported " << replay.numTicks() << " frames in " << secs << "s (" <<
+                 replay.numTicks()/std::max(secs, 1e-6) << " fps)" << std::endl;
+
+  return (rc ? 0 : 1);
+}
+
+//------
+
+bool
+CInvadersExport::
+exportY4M(const std::string &filename)
+{
+  format_   = Format::Y4M;
+  filename_ = filename;
+
+  fd_ = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  if (fd_ < 0) {
+    std::cerr << "Error: Failed to write '" << filename << "'" << std::endl;
+    return false;
+  }
+
+  char header[256];
+
+  snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F60:1 Ip A1:1 C420jpeg\n",
+           SCREEN_WIDTH, SCREEN_HEIGHT);
+
+  headerSize_ = strlen(header);
+
+  bool rc = (write(fd_, header, headerSize_) == ssize_t(headerSize_));
+
+  if (rc)
+    rc = exec();
+
+  close(fd_);
+
+  fd_ = -1;
+
+  return rc;
+}
+
+bool
+CInvadersExport::
+exportPNG(const std::string &dirname)
+{
+  format_   = Format::PNG;
+  filename_ = dirname;
+
+  mkdir(dirname.c_str(), 0755);
+
+  return exec();
+}
+
+bool
+CInvadersExport::
+exec()
+{
+  snapshot();
+
+  nextChunk_ = 0;
+  failed_    = false;
+
+  int numChunks = int(snapshots_.size());
+
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < std::min(numThreads_, numChunks); ++i) {
+    threads.emplace_back([this, numChunks]() {
+      int chunk;
+
+      while (! failed_ && (chunk = nextChunk_++) < numChunks)
+        renderChunk(chunk);
+    });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  snapshots_.clear();
+
+  if (! failed_ && wavFile_ != "" && ! mixer_.writeWav(wavFile_))
+    failed_ = true;
+
+  return ! failed_;
+}
+
+void
+CInvadersExport::
+snapshot()
+{
+  snapshots_.clear();
+
+  CSpaceInvaders game(levels_);
+
+  game.reset(replay_.seed());
+
+  // only this pass plays sounds (render threads have no mixer)
+  mixer_.clear();
+
+  if (wavFile_ != "")
+    App::setMixer(&mixer_);
+
+  bool diverged = false;
+
+  for (int t = 0; t < replay_.numTicks(); ++t) {
+    if (t % chunkTicks_ == 0)
+      snapshots_.push_back(std::make_unique<CSpaceInvaders>(game));
+
+    CReplay::applyTick(game, replay_.tick(t));
+
+    if (wavFile_ != "")
+      mixer_.mixTick();
+
+    // render anyway but the video will not match the recorded session
+    if (! diverged && ! replay_.checkHash(t, game.stateHash())) {
+      std::cerr << "Warning: Replay diverges from recording at tick " << t <<
+                   " (use CInvadersBisect for details)" << std::endl;
+      diverged = true;
+    }
+  }
+
+  App::setMixer(nullptr);
+}
+
+void
+CInvadersExport::
+renderChunk(int chunk)
+{
+  CSpaceInvaders &game = *snapshots_[chunk];
+
+  CDrawList drawList;
+
+  App::setDrawList(&drawList);
+
+  QImage image(SCREEN_WIDTH, SCREEN_HEIGHT, QImage::Format_RGB32);
+
+  QFont font("Helvetica", 20);
+
+  std::vector<uint8_t> data;
+
+  int t1 = chunk*chunkTicks_;
+  int t2 = std::min(t1 + chunkTicks_, replay_.numTicks());
+
+  for (int t = t1; t < t2 && ! failed_; ++t) {
+    CReplay::applyTick(game, replay_.tick(t));
+
+    drawList.clear();
+
+    game.draw();
+
+    image.fill(QColor(0,0,0));
+
+    QPainter p(&image);
+
+    p.setFont(font);
+
+    CDrawListPainter::paint(&p, drawList);
+
+    p.end();
+
+    writeFrame(t, image, data);
+  }
+
+  App::setDrawList(nullptr);
+}
+
+void
+CInvadersExport::
+writeFrame(int frame, const QImage &image, std::vector<uint8_t> &data)
+{
+  if (format_ == Format::PNG) {
+    char name[32];
+
+    snprintf(name, sizeof(name), "/frame%06d.png", frame);
+
+    if (! image.save(QString::fromStdString(filename_ + name))) {
+      std::cerr << "Error: Failed to write frame " << frame << std::endl;
+      failed_ = true;
+    }
+
+    return;
+  }
+
+  // RGB to YUV 4:2:0 (full range BT.601)
+  const int w = SCREEN_WIDTH, h = SCREEN_HEIGHT;
+
+  static const char frameTag[] = "FRAME\n";
+
+  const size_t tagSize   = sizeof(frameTag) - 1;
+  const size_t frameSize = tagSize + w*h + 2*(w/2)*(h/2);
+
+  data.resize(frameSize);
+
+  memcpy(&data[0], frameTag, tagSize);
+
+  uint8_t *Y = &data[tagSize];
+  uint8_t *U = Y + w*h;
+  uint8_t *V = U + (w/2)*(h/2);
+
+  for (int y = 0; y < h; ++y) {
+    const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+
+    for (int x = 0; x < w; ++x) {
+      int r = qRed(line[x]), g = qGreen(line[x]), b = qBlue(line[x]);
+
+      Y[y*w + x] = uint8_t((77*r + 150*g + 29*b) >> 8);
+    }
+  }
+
+  for (int y = 0; y < h/2; ++y) {
+    const QRgb *line1 = reinterpret_cast<const QRgb *>(image.constScanLine(2*y    ));
+    const QRgb *line2 = reinterpret_cast<const QRgb *>(image.constScanLine(2*y + 1));
+
+    for (int x = 0; x < w/2; ++x) {
+      QRgb c[4] = { line1[2*x], line1[2*x + 1], line2[2*x], line2[2*x + 1] };
+
+      int r = 0, g = 0, b = 0;
+
+      for (int i = 0; i < 4; ++i) {
+        r += qRed(c[i]); g += qGreen(c[i]); b += qBlue(c[i]);
+      }
+
+      r /= 4; g /= 4; b /= 4;
+
+      U[y*(w/2) + x] = uint8_t(std::min(std::max(128 + ((-43*r -  85*g + 128*b) >> 8), 0), 255));
+      V[y*(w/2) + x] = uint8_t(std::min(std::max(128 + ((128*r - 107*g -  21*b) >> 8), 0), 255));
+    }
+  }
+
+  off_t offset = off_t(headerSize_ + size_t(frame)*frameSize);
+
+  if (pwrite(fd_, &data[0], frameSize, offset) != ssize_t(frameSize)) {
+    std::cerr << "Error: Failed to write frame " << frame << std::endl;
+    failed_ = true;
+  }
+}
@@ -0,0 +1,20 @@
+TEMPLATE = app
+
+TARGET = CInvadersExport
+
+QT += gui
+
+CONFIG += console
+
+QMAKE_CXXFLAGS += -std=c++17
+
+INCLUDEPATH += . ../../src
+
+# Input
+HEADERS += ../../src/CSpaceInvaders.h ../../src/CSpriteMasks.h ../../src/CReplay.h ../../src/CDrawList.h ../../src/CDrawListPainter.h ../../src/CAudioMixer.h
+SOURCES += CInvadersExport.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../obj/export
+
+unix:LIBS += -lpthread
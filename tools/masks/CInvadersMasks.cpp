@@ -0,0 +1,177 @@
+#include <QImage>
+
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Generates src/CSpriteMasks.h, the 1 bit collision masks of the sprite
+// images used by CSpaceInvaders. A pixel is solid if its alpha is at least
+// ALPHA_SOLID. Each row is packed into (width + 63)/64 64 bit words, bit i of
+// word k being pixel column k*64 + i.
+//
+// The masks are compiled in rather than read from the images when the game
+// loads so headless backends (which never decode images) collide exactly as
+// the Qt build does. Rerun from src after changing an image:
+//
+//   ../bin/CInvadersMasks -o CSpriteMasks.h images/*.png
+
+enum { ALPHA_SOLID = 128 };
+
+struct MaskImage {
+  std::string           name;   // image file name (as passed)
+  std::string           symbol; // C identifier of bits array
+  int                   w { 0 };
+  int                   h { 0 };
+  std::vector<uint64_t> bits;
+};
+
+static bool
+loadMask(const std::string &filename, MaskImage &mask)
+{
+  QImage image;
+
+  if (! image.load(filename.c_str())) {
+    std::cerr << "Error: Failed to load image '" << filename << "'" << std::endl;
+    return false;
+  }
+
+  image = image.convertToFormat(QImage::Format_ARGB32);
+
+  mask.name = filename;
+  mask.w    = image.width();
+  mask.h    = image.height();
+
+  // symbol from base name without extension
+  std::string base = filename.substr(filename.find_last_of('/') + 1);
+
+  base = base.substr(0, base.find('.'));
+
+  mask.symbol = "spriteMaskBits_";
+
+  for (char c : base)
+    mask.symbol += (isalnum(c) ? c : '_');
+
+  int words = (mask.w + 63)/64;
+
+  mask.bits.assign(size_t(mask.h*words), 0);
+
+  for (int y = 0; y < mask.h; ++y) {
+    for (int x = 0; x < mask.w; ++x) {
+      if (qAlpha(image.pixel(x, y)) >= ALPHA_SOLID)
+        mask.bits[y*words + x/64] |= uint64_t(1) << (x & 63);
+    }
+  }
+
+  return true;
+}
+
+static bool
+writeHeader(FILE *fp, const std::vector<MaskImage> &masks)
+{
+  fprintf(fp, "#ifndef CSpriteMasks_H\n");
+  fprintf(fp, "#define CSpriteMasks_H\n");
+  fprintf(fp, "\n");
+  fprintf(fp, "// Collision masks of the sprite images (pixels with alpha >= %d), rows\n", ALPHA_SOLID);
+  fprintf(fp, "// packed into (w + 63)/64 64 bit words (bit i of word k is column k*64 + i).\n");
+  fprintf(fp, "//\n");
+  fprintf(fp, "// Generated by tools/masks (CInvadersMasks) from the images, do not edit.\n");
+  fprintf(fp, "\n");
+  fprintf(fp, "#include <cstdint>\n");
+  fprintf(fp, "\n");
+  fprintf(fp, "struct SpriteMaskDef {\n");
+  fprintf(fp, "  const char     *name; // image file name\n");
+  fprintf(fp, "  int             w;\n");
+  fprintf(fp, "  int             h;\n");
+  fprintf(fp, "  const uint64_t *bits; // h rows of (w + 63)/64 words\n");
+  fprintf(fp, "};\n");
+
+  for (const auto &mask : masks) {
+    int words = (mask.w + 63)/64;
+
+    fprintf(fp, "\n");
+    fprintf(fp, "constexpr uint64_t %s[] = {\n", mask.symbol.c_str());
+
+    for (int y = 0; y < mask.h; ++y) {
+      fprintf(fp, " ");
+
+      for (int k = 0; k < words; ++k)
+        fprintf(fp, " 0x%016" PRIx64 ",", mask.bits[y*words + k]);
+
+      fprintf(fp, "\n");
+    }
+
+    fprintf(fp, "};\n");
+  }
+
+  fprintf(fp, "\n");
+  fprintf(fp, "constexpr SpriteMaskDef spriteMaskDefs[] = {\n");
+
+  for (const auto &mask : masks)
+    fprintf(fp, "  { \"%s\", %d, %d, %s },\n", mask.name.c_str(), mask.w, mask.h,
+            mask.symbol.c_str());
+
+  fprintf(fp, "};\n");
+  fprintf(fp, "\n");
+  fprintf(fp, "constexpr int NUM_SPRITE_MASKS = sizeof(spriteMaskDefs)/sizeof(spriteMaskDefs[0]);\n");
+  fprintf(fp, "\n");
+
+  return fprintf(fp, "#endif\n") > 0;
+}
+
+static void
+usage()
+{
+  std::cerr << "Usage: CInvadersMasks [-o <file>] <image> ..." << std::endl;
+}
+
+int
+main(int argc, char **argv)
+{
+  std::string              outFile;
+  std::vector<std::string> imageFiles;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-o") == 0 && i < argc - 1)
+      outFile = argv[++i];
+    else if (argv[i][0] == '-') {
+      usage();
+      return 1;
+    }
+    else
+      imageFiles.push_back(argv[i]);
+  }
+
+  if (imageFiles.empty()) {
+    usage();
+    return 1;
+  }
+
+  std::vector<MaskImage> masks;
+
+  for (const auto &filename : imageFiles) {
+    MaskImage mask;
+
+    if (! loadMask(filename, mask))
+      return 1;
+
+    masks.push_back(mask);
+  }
+
+  FILE *fp = (outFile != "" ? fopen(outFile.c_str(), "w") : stdout);
+
+  if (! fp) {
+    std::cerr << "Error: Failed to write '" << outFile << "'" << std::endl;
+    return 1;
+  }
+
+  bool ok = writeHeader(fp, masks);
+
+  if (fp != stdout)
+    fclose(fp);
+
+  return (ok ? 0 : 1);
+}
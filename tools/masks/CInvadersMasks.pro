@@ -0,0 +1,17 @@
+TEMPLATE = app
+
+TARGET = CInvadersMasks
+
+QT += gui
+
+CONFIG += console
+
+QMAKE_CXXFLAGS += -std=c++17
+
+INCLUDEPATH += . ../../src
+
+# Input
+SOURCES += CInvadersMasks.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../obj/masks
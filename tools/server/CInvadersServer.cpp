@@ -0,0 +1,594 @@
+#include <CNullApp.h>
+#include <CSpaceInvaders.h>
+#include <CInvadersObs.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Hosts many CSpaceInvaders sessions in one process.
+//
+// A single epoll loop serves all clients (no thread per client). All messages
+// received in one loop iteration are processed as a batch, stepping every
+// requested session back to back, then each client's replies are flushed with
+// one write.
+class CInvadersServer {
+ public:
+  using Protocol = CInvadersProtocol;
+
+ public:
+  CInvadersServer(const CLevels *levels);
+ ~CInvadersServer();
+
+  // ticks advanced by each MSG_STEP (applies to sessions created after)
+  void setActionRepeat(int n) { actionRepeat_ = std::max(n, 1); }
+
+  bool listenUnix(const std::string &path);
+  bool listenTcp (int port);
+
+  int exec();
+
+ private:
+  struct Client {
+    int               fd      { -1 };
+    std::vector<char> in;
+    std::vector<char> out;
+    bool              writing { false };
+    bool              closed  { false };
+  };
+
+  struct Session {
+    int                             fd        { -1 };
+    std::unique_ptr<CSpaceInvaders> game;
+    int                             lastScore { 0 };
+  };
+
+  using Clients  = std::map<int, Client>;
+  using Sessions = std::unordered_map<uint32_t, Session>;
+
+  bool addListen(int fd);
+
+  void acceptClients();
+
+  void readClient(Client &client);
+
+  void processMessages(Client &client);
+
+  void processMessage(Client &client, const Protocol::MsgHeader &header, const char *payload);
+
+  void writeObs  (Client &client, uint32_t id, Session &session);
+  void writeError(Client &client, uint32_t id);
+
+  void writeData(Client &client, const void *data, size_t size);
+
+  void flushClient(Client &client);
+
+  void closeClient(Client &client);
+
+  void setWriting(Client &client, bool writing);
+
+ private:
+  const CLevels *levels_       { nullptr };
+  int            epfd_         { -1 };
+  int            listenFd_     { -1 };
+  std::string    unixPath_;
+  Clients        clients_;
+  Sessions       sessions_;
+  uint32_t       nextId_       { 1 };
+  long           numSteps_     { 0 };
+  int            actionRepeat_ { 1 };
+};
+
+//------
+
+static void
+usage()
+{
+  std::cerr << "Usage: CInvadersServer [-unix <path>|-tcp <port>] [-levels <file>] [-repeat <n>]" << std::endl;
+}
+
+int
+main(int argc, char **argv)
+{
+  std::string unixPath;
+  int         port = -1;
+  std::string levelsFile;
+  int         repeat = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-unix") == 0 && i < argc - 1)
+      unixPath = argv[++i];
+    else if (strcmp(argv[i], "-tcp") == 0 && i < argc - 1)
+      port = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-levels") == 0 && i < argc - 1)
+      levelsFile = argv[++i];
+    else if (strcmp(argv[i], "-repeat") == 0 && i < argc - 1)
+      repeat = atoi(argv[++i]);
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (unixPath == "" && port < 0)
+    unixPath = "/tmp/CInvadersServer.sock";
+
+  CLevels levels;
+
+  if (levelsFile != "" && ! levels.load(levelsFile))
+    return 1;
+
+  signal(SIGPIPE, SIG_IGN);
+
+  CInvadersServer server(&levels);
+
+  server.setActionRepeat(repeat);
+
+  if (unixPath != "") {
+    if (! server.listenUnix(unixPath))
+      return 1;
+  }
+  else {
+    if (! server.listenTcp(port))
+      return 1;
+  }
+
+  return server.exec();
+}
+
+//------
+
+CInvadersServer::
+CInvadersServer(const CLevels *levels) :
+ levels_(levels)
+{
+  epfd_ = epoll_create1(0);
+}
+
+CInvadersServer::
+~CInvadersServer()
+{
+  for (auto &pc : clients_)
+    close(pc.first);
+
+  if (listenFd_ >= 0)
+    close(listenFd_);
+
+  if (unixPath_ != "")
+    unlink(unixPath_.c_str());
+
+  if (epfd_ >= 0)
+    close(epfd_);
+}
+
+bool
+CInvadersServer::
+listenUnix(const std::string &path)
+{
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+  sockaddr_un addr;
+
+  memset(&addr, 0, sizeof(addr));
+
+  addr.sun_family = AF_UNIX;
+
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "Error: Socket path too long '" << path << "'" << std::endl;
+    return false;
+  }
+
+  strcpy(addr.sun_path, path.c_str());
+
+  unlink(path.c_str());
+
+  if (fd < 0 || bind(fd, (sockaddr *) &addr, sizeof(addr)) != 0) {
+    std::cerr << "Error: Failed to bind '" << path << "' " << strerror(errno) << std::endl;
+    return false;
+  }
+
+  unixPath_ = path;
+
+  std::cerr << "Listening on " << path << std::endl;
+
+  return addListen(fd);
+}
+
+bool
+CInvadersServer::
+listenTcp(int port)
+{
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+  int one = 1;
+
+  if (fd >= 0)
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in addr;
+
+  memset(&addr, 0, sizeof(addr));
+
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  if (fd < 0 || bind(fd, (sockaddr *) &addr, sizeof(addr)) != 0) {
+    std::cerr << "Error: Failed to bind port " << port << " " << strerror(errno) << std::endl;
+    return false;
+  }
+
+  std::cerr << "Listening on 127.0.0.1:" << port << std::endl;
+
+  return addListen(fd);
+}
+
+bool
+CInvadersServer::
+addListen(int fd)
+{
+  if (listen(fd, 128) != 0) {
+    std::cerr << "Error: listen failed " << strerror(errno) << std::endl;
+    close(fd);
+    return false;
+  }
+
+  listenFd_ = fd;
+
+  epoll_event event;
+
+  event.events  = EPOLLIN;
+  event.data.fd = fd;
+
+  return (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &event) == 0);
+}
+
+int
+CInvadersServer::
+exec()
+{
+  enum { MAX_EVENTS = 256 };
+
+  epoll_event events[MAX_EVENTS];
+
+  for (;;) {
+    int n = epoll_wait(epfd_, events, MAX_EVENTS, -1);
+
+    if (n < 0) {
+      if (errno == EINTR) continue;
+
+      std::cerr << "Error: epoll_wait failed " << strerror(errno) << std::endl;
+      return 1;
+    }
+
+    // read and process everything available (sessions stepped in one batch)
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+
+      if (fd == listenFd_) {
+        acceptClients();
+        continue;
+      }
+
+      auto pc = clients_.find(fd);
+      if (pc == clients_.end()) continue;
+
+      Client &client = (*pc).second;
+
+      if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        readClient(client);
+
+        processMessages(client);
+      }
+    }
+
+    // flush replies (one write per client) and drop closed clients
+    for (auto pc = clients_.begin(); pc != clients_.end(); ) {
+      Client &client = (*pc).second;
+
+      if (! client.closed)
+        flushClient(client);
+
+      if (client.closed) {
+        closeClient(client);
+
+        pc = clients_.erase(pc);
+      }
+      else
+        ++pc;
+    }
+  }
+
+  return 0;
+}
+
+void
+CInvadersServer::
+acceptClients()
+{
+  for (;;) {
+    int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK);
+
+    if (fd < 0) break;
+
+    int one = 1;
+
+    (void) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    Client &client = clients_[fd];
+
+    client.fd = fd;
+
+    epoll_event event;
+
+    event.events  = EPOLLIN;
+    event.data.fd = fd;
+
+    epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &event);
+  }
+}
+
+void
+CInvadersServer::
+readClient(Client &client)
+{
+  char buffer[65536];
+
+  for (;;) {
+    ssize_t n = read(client.fd, buffer, sizeof(buffer));
+
+    if (n > 0) {
+      client.in.insert(client.in.end(), buffer, buffer + n);
+      continue;
+    }
+
+    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+      client.closed = true;
+
+    break;
+  }
+}
+
+void
+CInvadersServer::
+processMessages(Client &client)
+{
+  size_t pos = 0;
+
+  while (client.in.size() - pos >= sizeof(Protocol::MsgHeader)) {
+    Protocol::MsgHeader header;
+
+    memcpy(&header, &client.in[pos], sizeof(header));
+
+    if (header.size > Protocol::MAX_PAYLOAD) {
+      client.closed = true;
+      break;
+    }
+
+    if (client.in.size() - pos < sizeof(header) + header.size)
+      break;
+
+    processMessage(client, header, &client.in[pos + sizeof(header)]);
+
+    pos += sizeof(header) + header.size;
+  }
+
+  client.in.erase(client.in.begin(), client.in.begin() + pos);
+}
+
+void
+CInvadersServer::
+processMessage(Client &client, const Protocol::MsgHeader &header, const char *payload)
+{
+  switch (header.type) {
+    case Protocol::MSG_CREATE: {
+      if (header.size != sizeof(Protocol::ResetMsg))
+        return writeError(client, header.session);
+
+      Protocol::ResetMsg msg;
+
+      memcpy(&msg, payload, sizeof(msg));
+
+      uint32_t id = nextId_++;
+
+      Session &session = sessions_[id];
+
+      session.fd   = client.fd;
+      session.game = std::make_unique<CSpaceInvaders>(levels_);
+
+      session.game->setActionRepeat  (actionRepeat_);
+      session.game->setEffectsEnabled(false);
+
+      session.game->reset(msg.seed);
+
+      writeObs(client, id, session);
+
+      break;
+    }
+    case Protocol::MSG_RESET:
+    case Protocol::MSG_STEP:
+    case Protocol::MSG_CLOSE: {
+      auto ps = sessions_.find(header.session);
+
+      if (ps == sessions_.end() || (*ps).second.fd != client.fd)
+        return writeError(client, header.session);
+
+      Session &session = (*ps).second;
+
+      if      (header.type == Protocol::MSG_RESET) {
+        if (header.size != sizeof(Protocol::ResetMsg))
+          return writeError(client, header.session);
+
+        Protocol::ResetMsg msg;
+
+        memcpy(&msg, payload, sizeof(msg));
+
+        session.game->reset(msg.seed);
+
+        session.lastScore = 0;
+
+        writeObs(client, header.session, session);
+      }
+      else if (header.type == Protocol::MSG_STEP) {
+        if (header.size != sizeof(Protocol::StepMsg))
+          return writeError(client, header.session);
+
+        Protocol::StepMsg msg;
+
+        memcpy(&msg, payload, sizeof(msg));
+
+        Input input;
+
+        input.left  = (msg.actions & Protocol::ACTION_LEFT );
+        input.right = (msg.actions & Protocol::ACTION_RIGHT);
+        input.fire  = (msg.actions & Protocol::ACTION_FIRE );
+
+        session.game->setInput(input);
+
+        session.game->step();
+
+        ++numSteps_;
+
+        writeObs(client, header.session, session);
+      }
+      else
+        sessions_.erase(ps);
+
+      break;
+    }
+    default:
+      writeError(client, header.session);
+      break;
+  }
+}
+
+void
+CInvadersServer::
+writeObs(Client &client, uint32_t id, Session &session)
+{
+  const CSpaceInvaders &game = *session.game;
+
+  size_t size = CInvadersObs::size(game);
+
+  Protocol::MsgHeader header;
+
+  memset(&header, 0, sizeof(header));
+
+  header.type    = Protocol::MSG_OBS;
+  header.session = id;
+  header.size    = uint32_t(size);
+
+  writeData(client, &header, sizeof(header));
+
+  // encode in place at end of output buffer
+  size_t pos = client.out.size();
+
+  client.out.resize(pos + size);
+
+  CInvadersObs::encode(game, game.getScore() - session.lastScore, &client.out[pos]);
+
+  session.lastScore = game.getScore();
+}
+
+void
+CInvadersServer::
+writeError(Client &client, uint32_t id)
+{
+  Protocol::MsgHeader header;
+
+  memset(&header, 0, sizeof(header));
+
+  header.type    = Protocol::MSG_ERROR;
+  header.session = id;
+
+  writeData(client, &header, sizeof(header));
+}
+
+void
+CInvadersServer::
+writeData(Client &client, const void *data, size_t size)
+{
+  const char *p = static_cast<const char *>(data);
+
+  client.out.insert(client.out.end(), p, p + size);
+}
+
+void
+CInvadersServer::
+flushClient(Client &client)
+{
+  size_t pos = 0;
+
+  while (pos < client.out.size()) {
+    ssize_t n = send(client.fd, &client.out[pos], client.out.size() - pos, MSG_NOSIGNAL);
+
+    if (n > 0) {
+      pos += n;
+      continue;
+    }
+
+    if (n < 0 && errno == EINTR) continue;
+
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      break;
+
+    client.closed = true;
+
+    return;
+  }
+
+  client.out.erase(client.out.begin(), client.out.begin() + pos);
+
+  // wait for socket to drain before reading more from a slow client
+  setWriting(client, ! client.out.empty());
+}
+
+void
+CInvadersServer::
+setWriting(Client &client, bool writing)
+{
+  if (client.writing == writing) return;
+
+  client.writing = writing;
+
+  epoll_event event;
+
+  event.events  = (writing ? EPOLLOUT : EPOLLIN);
+  event.data.fd = client.fd;
+
+  epoll_ctl(epfd_, EPOLL_CTL_MOD, client.fd, &event);
+}
+
+void
+CInvadersServer::
+closeClient(Client &client)
+{
+  for (auto ps = sessions_.begin(); ps != sessions_.end(); ) {
+    if ((*ps).second.fd == client.fd)
+      ps = sessions_.erase(ps);
+    else
+      ++ps;
+  }
+
+  epoll_ctl(epfd_, EPOLL_CTL_DEL, client.fd, nullptr);
+
+  close(client.fd);
+
+  std::cerr << "Client closed (" << clients_.size() - 1 << " clients, " <<
+               sessions_.size() << " sessions open, " << numSteps_ << " steps served)" << std::endl;
+}
@@ -0,0 +1,17 @@
+TEMPLATE = app
+
+TARGET = CInvadersServer
+
+CONFIG -= qt
+CONFIG += console
+
+QMAKE_CXXFLAGS += -std=c++17
+
+INCLUDEPATH += . ../../src
+
+# Input
+HEADERS += ../../src/CSpaceInvaders.h ../../src/CSpriteMasks.h ../../src/CNullApp.h ../../src/CAudioMixer.h ../../src/CInvadersProtocol.h ../../src/CInvadersObs.h
+SOURCES += CInvadersServer.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../obj/server
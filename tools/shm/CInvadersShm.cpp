@@ -0,0 +1,116 @@
+#include <CNullApp.h>
+#include <CSpaceInvaders.h>
+#include <CInvadersObs.h>
+#include <CInvadersShmChannel.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Hosts one CSpaceInvaders session for an agent process over a shared memory
+// channel (see CInvadersShmChannel.h).
+//
+// Each action slot read produces one observation slot, encoded directly into
+// the mapped ring. The host exits when it reads MSG_CLOSE.
+
+static void
+usage()
+{
+  std::cerr << "Usage: CInvadersShm [-name <shm_name>] [-slots <n>] [-levels <file>] [-repeat <n>]" << std::endl;
+}
+
+int
+main(int argc, char **argv)
+{
+  using Protocol = CInvadersProtocol;
+  using Channel  = CInvadersShmChannel;
+
+  std::string name     = "/CInvadersShm";
+  int         numSlots = 4;
+  std::string levelsFile;
+  int         repeat   = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-name") == 0 && i < argc - 1)
+      name = argv[++i];
+    else if (strcmp(argv[i], "-slots") == 0 && i < argc - 1)
+      numSlots = std::max(atoi(argv[++i]), 1);
+    else if (strcmp(argv[i], "-levels") == 0 && i < argc - 1)
+      levelsFile = argv[++i];
+    else if (strcmp(argv[i], "-repeat") == 0 && i < argc - 1)
+      repeat = atoi(argv[++i]);
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  CLevels levels;
+
+  if (levelsFile != "" && ! levels.load(levelsFile))
+    return 1;
+
+  Channel channel;
+
+  if (! channel.create(name, uint32_t(numSlots), CInvadersObs::maxSize(levels)))
+    return 1;
+
+  std::cerr << "Serving on shared memory " << name << std::endl;
+
+  CSpaceInvaders game(&levels);
+
+  game.setActionRepeat  (repeat);
+  game.setEffectsEnabled(false);
+
+  CShmRing &actions      = channel.actions();
+  CShmRing &observations = channel.observations();
+
+  int lastScore = 0;
+
+  for (;;) {
+    const Channel::ActionSlot *action =
+      static_cast<const Channel::ActionSlot *>(actions.beginRead());
+
+    uint8_t type = action->type;
+
+    if      (type == Protocol::MSG_RESET) {
+      game.reset(action->seed);
+
+      lastScore = 0;
+    }
+    else if (type == Protocol::MSG_STEP) {
+      Input input;
+
+      input.left  = (action->actions & Protocol::ACTION_LEFT );
+      input.right = (action->actions & Protocol::ACTION_RIGHT);
+      input.fire  = (action->actions & Protocol::ACTION_FIRE );
+
+      game.setInput(input);
+
+      game.step();
+    }
+
+    actions.endRead();
+
+    if (type == Protocol::MSG_CLOSE)
+      break;
+
+    // encode observation in place in the next free slot
+    char *slot = static_cast<char *>(observations.beginWrite());
+
+    Channel::ObsSlot *obsSlot = reinterpret_cast<Channel::ObsSlot *>(slot);
+
+    if (type == Protocol::MSG_RESET || type == Protocol::MSG_STEP) {
+      obsSlot->size = uint32_t(CInvadersObs::encode(game, game.getScore() - lastScore,
+                                                    slot + sizeof(Channel::ObsSlot)));
+
+      lastScore = game.getScore();
+    }
+    else
+      obsSlot->size = 0; // bad action type
+
+    observations.endWrite();
+  }
+
+  return 0;
+}
@@ -0,0 +1,20 @@
+TEMPLATE = app
+
+TARGET = CInvadersShm
+
+CONFIG -= qt
+CONFIG += console
+
+QMAKE_CXXFLAGS += -std=c++17
+
+INCLUDEPATH += . ../../src
+
+# Input
+HEADERS += ../../src/CSpaceInvaders.h ../../src/CSpriteMasks.h ../../src/CNullApp.h ../../src/CAudioMixer.h ../../src/CInvadersProtocol.h \
+           ../../src/CInvadersObs.h ../../src/CInvadersShmChannel.h ../../src/CShmRing.h
+SOURCES += CInvadersShm.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../obj/shm
+
+unix:LIBS += -lrt
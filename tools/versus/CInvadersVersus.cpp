@@ -0,0 +1,344 @@
+#include <CNullApp.h>
+#include <CSpaceInvaders.h>
+#include <CInvadersPolicy.h>
+#include <CRollbackSession.h>
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Plays a two player rollback match between two CRollbackSession peers in one
+// process, each driven by a scripted bot, over UDP loopback sockets. Bots
+// replace a fraction of their actions with random ones (-noise) so the two
+// boards play differently and predictions of the remote input miss.
+//
+// Outgoing packets pass through a simulated link which delays them (latency
+// plus random jitter) and drops a fraction of them before they are sent.
+// Frames run on a virtual 60Hz clock (or real time with -realtime). Both
+// peers record the checksum of every confirmed tick and the run fails if they
+// differ (a desync), if a peer's own packet hash check finds a desync, or if
+// the peers do not confirm every tick.
+
+// one direction of simulated network
+class CLossyLink {
+ public:
+  CLossyLink(int fd, double latency, double jitter, double loss, uint64_t seed) :
+   fd_(fd), latency_(latency), jitter_(jitter), loss_(loss), rng_(seed) {
+  }
+
+  long numSent   () const { return numSent_; }
+  long numDropped() const { return numDropped_; }
+
+  void send(double now, const char *data, size_t size) {
+    if (rng_.random() < loss_) {
+      ++numDropped_;
+      return;
+    }
+
+    Packet packet;
+
+    packet.time = now + latency_ + jitter_*rng_.random();
+
+    packet.data.assign(data, data + size);
+
+    // keep queue in release order (jitter may reorder packets)
+    auto p = queue_.end();
+
+    while (p != queue_.begin() && (p - 1)->time > packet.time)
+      --p;
+
+    queue_.insert(p, packet);
+  }
+
+  // send packets due by now
+  void flush(double now) {
+    while (! queue_.empty() && queue_.front().time <= now) {
+      const Packet &packet = queue_.front();
+
+      if (::send(fd_, &packet.data[0], packet.data.size(), 0) < 0)
+        std::cerr << "Error: send: " << strerror(errno) << std::endl;
+
+      ++numSent_;
+
+      queue_.pop_front();
+    }
+  }
+
+ private:
+  struct Packet {
+    double            time { 0.0 };
+    std::vector<char> data;
+  };
+
+  int                 fd_         { -1 };
+  double              latency_    { 0.0 };
+  double              jitter_     { 0.0 };
+  double              loss_       { 0.0 };
+  Random              rng_;
+  std::deque<Packet>  queue_;
+  long                numSent_    { 0 };
+  long                numDropped_ { 0 };
+};
+
+//---
+
+struct Peer {
+  int                               fd { -1 };
+  std::unique_ptr<CRollbackSession> session;
+  std::unique_ptr<CLossyLink>       link;
+  CScriptedPolicy                   bot;
+  Random                            botRng;
+  std::vector<uint64_t>             checksums;  // per confirmed tick
+  double                            maxFrame      { 0.0 }; // secs
+  double                            maxRollFrame  { 0.0 }; // secs (frames with rollback)
+  int                               maxRollTicks  { 0 };   // resim ticks of that frame
+};
+
+static int
+openSocket(sockaddr_in &addr)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+
+  if (fd < 0) {
+    std::cerr << "Error: socket: " << strerror(errno) << std::endl;
+    return -1;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port        = 0;
+
+  socklen_t len = sizeof(addr);
+
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len) < 0) {
+    std::cerr << "Error: bind: " << strerror(errno) << std::endl;
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+static void
+usage()
+{
+  std::cerr << "Usage: CInvadersVersus [-ticks <n>] [-latency <ms>] [-jitter <ms>] " <<
+               "[-loss <p>] [-rollback <n>] [-delay <n>] [-noise <p>] [-seed <n>] [-realtime] " <<
+               "[-levels <file>]" << std::endl;
+}
+
+int
+main(int argc, char **argv)
+{
+  long        numTicks = 3600;
+  double      latency  = 50.0; // ms one way
+  double      jitter   = 10.0;
+  double      loss     = 0.05;
+  double      noise    = 0.1;
+  uint64_t    seed     = 1;
+  bool        realtime = false;
+  std::string levelsFile;
+
+  CRollbackSession::Params params;
+
+  for (int i = 1; i < argc; ++i) {
+    if      (strcmp(argv[i], "-ticks") == 0 && i < argc - 1)
+      numTicks = std::max(atol(argv[++i]), 1L);
+    else if (strcmp(argv[i], "-latency") == 0 && i < argc - 1)
+      latency = std::max(atof(argv[++i]), 0.0);
+    else if (strcmp(argv[i], "-jitter") == 0 && i < argc - 1)
+      jitter = std::max(atof(argv[++i]), 0.0);
+    else if (strcmp(argv[i], "-loss") == 0 && i < argc - 1)
+      loss = std::min(std::max(atof(argv[++i]), 0.0), 0.9);
+    else if (strcmp(argv[i], "-rollback") == 0 && i < argc - 1)
+      params.maxRollback = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-delay") == 0 && i < argc - 1)
+      params.inputDelay = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-noise") == 0 && i < argc - 1)
+      noise = std::min(std::max(atof(argv[++i]), 0.0), 1.0);
+    else if (strcmp(argv[i], "-seed") == 0 && i < argc - 1)
+      seed = strtoull(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "-realtime") == 0)
+      realtime = true;
+    else if (strcmp(argv[i], "-levels") == 0 && i < argc - 1)
+      levelsFile = argv[++i];
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  CLevels levels;
+
+  if (levelsFile != "" && ! levels.load(levelsFile))
+    return 1;
+
+  //---
+
+  // loopback socket pair
+  Peer        peers[2];
+  sockaddr_in addrs[2];
+
+  for (int i = 0; i < 2; ++i) {
+    peers[i].fd = openSocket(addrs[i]);
+
+    if (peers[i].fd < 0)
+      return 1;
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    if (connect(peers[i].fd, reinterpret_cast<sockaddr *>(&addrs[1 - i]), sizeof(addrs[0])) < 0) {
+      std::cerr << "Error: connect: " << strerror(errno) << std::endl;
+      return 1;
+    }
+
+    peers[i].session = std::make_unique<CRollbackSession>(i, &levels, params);
+    peers[i].link    = std::make_unique<CLossyLink>(peers[i].fd, latency/1000.0,
+                                                    jitter/1000.0, loss, seed*2 + i);
+
+    peers[i].session->start(seed);
+
+    peers[i].botRng.setSeed(seed*2 + i + 100);
+  }
+
+  params = peers[0].session->params(); // clamped
+
+  //---
+
+  using Clock = std::chrono::steady_clock;
+
+  const double period = 1.0/60.0;
+
+  auto start = Clock::now();
+
+  long numFrames = 0;
+
+  char packet[CRollbackSession::MAX_PACKET];
+
+  // run until both peers have confirmed every tick
+  while (peers[0].checksums.size() < size_t(numTicks) ||
+         peers[1].checksums.size() < size_t(numTicks)) {
+    double now = numFrames*period;
+
+    for (auto &peer : peers) {
+      CRollbackSession &session = *peer.session;
+
+      ssize_t n;
+
+      while ((n = recv(peer.fd, packet, sizeof(packet), 0)) > 0)
+        session.receivePacket(packet, size_t(n));
+
+      auto t1 = Clock::now();
+
+      long resim = session.numResimTicks();
+
+      // bot plays its own board (idle once the tick count is reached)
+      uint8_t action = 0;
+
+      if (session.tick() < numTicks) {
+        action = peer.bot.act(session.game().game(session.localPlayer()));
+
+        if (peer.botRng.random() < noise)
+          action = uint8_t(peer.botRng.random()*8) & 7;
+      }
+
+      if (session.tick() < numTicks + params.maxRollback)
+        session.advance(action);
+
+      double secs = std::chrono::duration<double>(Clock::now() - t1).count();
+
+      peer.maxFrame = std::max(peer.maxFrame, secs);
+
+      int rollTicks = int(session.numResimTicks() - resim);
+
+      if (rollTicks > 0 && secs > peer.maxRollFrame) {
+        peer.maxRollFrame = secs;
+        peer.maxRollTicks = rollTicks;
+      }
+
+      while (long(peer.checksums.size()) < std::min(session.confirmedTick(), numTicks))
+        peer.checksums.push_back(session.checksum(long(peer.checksums.size())));
+
+      size_t size = session.makePacket(packet);
+
+      peer.link->send(now, packet, size);
+    }
+
+    for (auto &peer : peers)
+      peer.link->flush(now);
+
+    ++numFrames;
+
+    if (realtime)
+      std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(numFrames*period)));
+
+    // no progress possible (e.g. total loss)
+    if (numFrames > 100*numTicks) {
+      std::cerr << "Error: Peers stopped confirming ticks" << std::endl;
+      return 1;
+    }
+  }
+
+  //---
+
+  long firstDiff = -1;
+
+  for (long t = 0; t < numTicks; ++t) {
+    if (peers[0].checksums[t] != peers[1].checksums[t]) {
+      firstDiff = t;
+      break;
+    }
+  }
+
+  // desync seen by the sessions' packet hash checks
+  long peerDiff = std::max(peers[0].session->desyncTick(), peers[1].session->desyncTick());
+
+  const CVersusGame &game = peers[0].session->game();
+
+  std::cout << "Ticks: " << numTicks << " in " << numFrames << " frames (latency " <<
+               latency << "ms, jitter " << jitter << "ms, loss " << loss << ", rollback " <<
+               params.maxRollback << ", delay " << params.inputDelay << ")\n";
+
+  std::cout << "Scores: " << game.game(0).getScore() << " - " << game.game(1).getScore() <<
+               " (winner " << (game.winner() >= 0 ? std::to_string(game.winner() + 1) : "none") << ")\n";
+
+  for (int i = 0; i < 2; ++i) {
+    const Peer             &peer    = peers[i];
+    const CRollbackSession &session = *peer.session;
+
+    std::cout << "Peer " << i + 1 << ": " << session.numRollbacks() << " rollbacks, " <<
+                 session.numResimTicks() << " resimulated ticks (max " <<
+                 session.maxRollbackTicks() << "), " << session.numStalls() << " stalls, " <<
+                 session.numSyncWaits() << " sync waits, " << peer.link->numSent() <<
+                 " packets sent, " << peer.link->numDropped() << " dropped\n";
+
+    std::cout << "  worst frame " << 1000.0*peer.maxFrame << "ms, worst rollback frame " <<
+                 1000.0*peer.maxRollFrame << "ms (" << peer.maxRollTicks << " ticks)\n";
+  }
+
+  for (auto &peer : peers)
+    close(peer.fd);
+
+  if (firstDiff >= 0 || peerDiff >= 0) {
+    std::cout << "DESYNC at tick " << firstDiff << " (peer hash check " << peerDiff << ")" << std::endl;
+    return 1;
+  }
+
+  std::cout << "In sync: " << numTicks << " tick checksums match" << std::endl;
+
+  return 0;
+}
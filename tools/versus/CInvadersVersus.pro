@@ -0,0 +1,20 @@
+TEMPLATE = app
+
+TARGET = CInvadersVersus
+
+CONFIG -= qt
+CONFIG += console
+
+QMAKE_CXXFLAGS += -std=c++17
+
+INCLUDEPATH += . ../../src
+
+# Input
+HEADERS += ../../src/CSpaceInvaders.h ../../src/CSpriteMasks.h ../../src/CNullApp.h ../../src/CAudioMixer.h ../../src/CInvadersPolicy.h \
+           ../../src/CVersusGame.h ../../src/CRollbackSession.h
+SOURCES += CInvadersVersus.cpp
+
+DESTDIR     = ../../bin
+OBJECTS_DIR = ../../obj/versus
+
+unix:LIBS += -lpthread